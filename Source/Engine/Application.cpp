@@ -107,6 +107,9 @@ namespace Silent
         // Input.
         _work.Input.Initialize();
 
+        // Tick pipeline.
+        InitializePipeline();
+
         // Finish.
         Log("Startup complete.");
         _isRunning = true;
@@ -123,6 +126,17 @@ namespace Silent
         _work.Renderer->Deinitialize();
 
         // Parallelism.
+        if constexpr (IS_PARALLEL_STATS_BUILD)
+        {
+            // Dump scheduler stats.
+            auto path       = _work.Filesystem.GetWorkFolder() / (std::string(PARALLEL_STATS_FILENAME) + JSON_FILE_EXT);
+            auto outputFile = std::ofstream(path);
+            if (outputFile.is_open())
+            {
+                outputFile << g_Parallel.GetStatsJson().dump(JSON_INDENT_SIZE);
+                outputFile.close();
+            }
+        }
         g_Parallel.Deinitialize();
 
         // SDL.
@@ -140,9 +154,17 @@ namespace Silent
         while (_isRunning)
         {
             _work.Time.Update();
+            g_Parallel.BeginFrame(1000000 / TimeManager::TPS);
 
-            Update();
-            Render();
+            _pipeline.Execute();
+
+            // Restart workers with new topology outside pipeline.
+            if (g_DebugData.IsParallelRestartPending)
+            {
+                g_Parallel.Deinitialize();
+                g_Parallel.Initialize();
+                g_DebugData.IsParallelRestartPending = false;
+            }
 
             _work.Time.WaitForNextTick();
         }
@@ -180,14 +202,38 @@ namespace Silent
         }
     }
 
-    void ApplicationManager::Update()
+    void ApplicationManager::InitializePipeline()
     {
-        PollEvents();
-        _work.Input.Update(*_window, _mouseWheelAxis);
+        // Phases are declared in serial order. SDL, ImGui and renderer phases are bound to main thread.
+        // Main thread tasks may resume coroutines touching anything, so they run first and write everything.
+        _pipeline.Clear();
+        _pipeline.AddPhase("Main thread tasks", {},
+                           { TickResource::Window, TickResource::Input, TickResource::Options, TickResource::Assets, TickResource::Game, TickResource::Debug, TickResource::Renderer },
+                           true, []()
+        {
+            g_Parallel.ExecuteMainThreadTasks();
+        });
+        _pipeline.AddPhase("Poll events", {}, { TickResource::Window, TickResource::Input, TickResource::Options, TickResource::Renderer }, true, [this]()
+        {
+            PollEvents();
+        });
+        _pipeline.AddPhase("Input", { TickResource::Window, TickResource::Options }, { TickResource::Input }, true, [this]()
+        {
+            _work.Input.Update(*_window, _mouseWheelAxis);
+        });
 
-        // TODO: Update game state here.
+        // TODO: Add game state phases here. Phases without main thread affinity run as parallel jobs.
 
-        UpdateDebug();
+        _pipeline.AddPhase("Debug", { TickResource::Window, TickResource::Input, TickResource::Assets, TickResource::Game },
+                           { TickResource::Options, TickResource::Debug, TickResource::Renderer }, true, []()
+        {
+            UpdateDebug();
+        });
+        _pipeline.AddPhase("Render", { TickResource::Window, TickResource::Options, TickResource::Assets, TickResource::Game, TickResource::Debug },
+                           { TickResource::Renderer }, true, [this]()
+        {
+            Render();
+        });
     }
 
     void ApplicationManager::Render()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Input/Input.h"
+#include "Engine/Pipeline.h"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Services/Assets/Assets.h"
 #include "Engine/Services/Filesystem.h"
@@ -36,6 +37,7 @@ namespace Silent
         bool            _isRunning = false;
         ApplicationWork _work      = {};
         SDL_Window*     _window    = nullptr;
+        TickPipeline    _pipeline  = {};
 
         Vector2 _mouseWheelAxis = Vector2::Zero;
 
@@ -68,7 +70,7 @@ namespace Silent
     private:
         // Helpers
 
-        void Update();
+        void InitializePipeline();
         void Render();
         void PollEvents();
     };
@@ -441,12 +441,11 @@ namespace Silent::Input
         };
 
         // Update action states asynchronously.
-        auto tasks = ParallelTasks
-        {
-            [&]() { updateUserActions(); },
-            [&]() { updateRawActions(); }
-        };
-        g_Parallel.AddTasks(tasks).wait();
+        auto group = g_Parallel.CreateGroup();
+        g_Parallel.AddJob(group, [&]() { updateUserActions(); });
+        g_Parallel.AddJob(group, [&]() { updateRawActions(); });
+        g_Parallel.CloseGroup(group);
+        group.Wait();
     }
 
     void InputManager::HandleHotkeyActions()
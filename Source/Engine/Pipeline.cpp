@@ -0,0 +1,83 @@
+#include "Framework.h"
+#include "Engine/Pipeline.h"
+
+#include "Utils/ParallelGraph.h"
+
+using namespace Silent::Utils;
+
+namespace Silent
+{
+    static uint ToResourceMask(const std::vector<TickResource>& resources)
+    {
+        uint mask = 0;
+        for (auto resource : resources)
+        {
+            mask |= 1 << (int)resource;
+        }
+
+        return mask;
+    }
+
+    uint TickPipeline::GetPhaseCount() const
+    {
+        return (uint)_phases.size();
+    }
+
+    const TickPhase& TickPipeline::GetPhase(int phaseId) const
+    {
+        return _phases[phaseId];
+    }
+
+    int TickPipeline::AddPhase(const std::string& name, const std::vector<TickResource>& reads, const std::vector<TickResource>& writes, bool isMainThread,
+                               const ParallelTask& task)
+    {
+        _phases.push_back(TickPhase
+        {
+            .Name         = name,
+            .Task         = task,
+            .ReadMask     = ToResourceMask(reads),
+            .WriteMask    = ToResourceMask(writes),
+            .IsMainThread = isMainThread
+        });
+        _isDirty = true;
+
+        return (int)_phases.size() - 1;
+    }
+
+    void TickPipeline::Clear()
+    {
+        _phases.clear();
+        _isDirty = true;
+    }
+
+    void TickPipeline::Execute()
+    {
+        if (_isDirty)
+        {
+            Build();
+        }
+
+        _graph.Execute(ParallelPriority::Critical);
+    }
+
+    void TickPipeline::Build()
+    {
+        // Add dependency on every earlier phase with conflicting access: write after read, read after write, or write after write.
+        _graph.Clear();
+        for (int i = 0; i < _phases.size(); i++)
+        {
+            const auto& phase = _phases[i];
+            _graph.AddNode(phase.Task, phase.IsMainThread);
+            for (int j = 0; j < i; j++)
+            {
+                const auto& prevPhase = _phases[j];
+                if ((prevPhase.WriteMask & (phase.ReadMask | phase.WriteMask)) || (prevPhase.ReadMask & phase.WriteMask))
+                {
+                    _graph.AddDependency(j, i);
+                }
+            }
+        }
+
+        _isDirty = false;
+    }
+}
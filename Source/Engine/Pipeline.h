@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Utils/ParallelGraph.h"
+
+namespace Silent
+{
+    /** @brief Shared state accessed by tick phases. */
+    enum class TickResource
+    {
+        Window,
+        Input,
+        Options,
+        Assets,
+        Game,
+        Debug,
+        Renderer,
+
+        Count
+    };
+
+    struct TickPhase
+    {
+        std::string         Name         = {};
+        Utils::ParallelTask Task         = {};
+        uint                ReadMask     = 0; // Bit per `TickResource`.
+        uint                WriteMask    = 0; // Bit per `TickResource`.
+        bool                IsMainThread = false;
+    };
+
+    /** @brief Tick as a dependency graph of phases declaring the resources they read and write.
+     * Each phase depends on every earlier phase with a conflicting access, so results match running phases serially in declaration order.
+     * Phases are executed by `Utils::ParallelGraph`: main thread phases run on calling thread, other phases run as jobs once their dependencies complete. */
+    class TickPipeline
+    {
+    private:
+        // Fields
+
+        std::vector<TickPhase> _phases  = {};
+        Utils::ParallelGraph   _graph   = {}; // Node ID = phase ID.
+        bool                   _isDirty = false;
+
+    public:
+        // Constructors
+
+        TickPipeline() = default;
+
+        // Getters
+
+        uint             GetPhaseCount() const;
+        const TickPhase& GetPhase(int phaseId) const;
+
+        // Utilities
+
+        int  AddPhase(const std::string& name, const std::vector<TickResource>& reads, const std::vector<TickResource>& writes, bool isMainThread,
+                      const Utils::ParallelTask& task);
+        void Clear();
+
+        /** @brief Executes all phases and returns once complete. Must be called from main thread. */
+        void Execute();
+
+    private:
+        // Helpers
+
+        void Build();
+    };
+}
@@ -52,7 +52,7 @@ namespace Silent::Renderer
 
             // Load asset.
             auto name = "TIM\\" + filename.filename().string();
-            assets.LoadAsset(name).wait();
+            assets.LoadAsset(name).Wait();
 
             // Get asset data.
             const auto& asset = assets.GetAsset(name);
@@ -4,6 +4,7 @@
 #include "Engine/Services/Assets/Parsers/Tmd.h"
 #include "Engine/Services/Assets/Parsers/Tim.h"
 #include "Utils/Parallel.h"
+#include "Utils/Task.h"
 #include "Utils/Utils.h"
 
 using namespace Silent::Utils;
@@ -112,81 +113,78 @@ namespace Silent::Assets
         Log("Registered " + std::to_string(_assets.size()) + " assets.", LogLevel::Info, LogMode::Debug);
     }
 
-    std::future<void> AssetManager::LoadAsset(int assetIdx)
+    ParallelHandle AssetManager::LoadAsset(int assetIdx)
     {
-        // Get asset.
-        if (assetIdx < 0 || assetIdx >= _assets.size())
+        // Load asynchronously on background lane. Callers may chain continuations on returned handle.
+        auto group = g_Parallel.CreateGroup(ParallelPriority::Background);
+        if (!BeginLoad(assetIdx, group))
         {
-            Log("Attempted to load invalid asset " + std::to_string(assetIdx) + ".", LogLevel::Warning, LogMode::Debug);
-            return GenerateReadyFuture();
+            g_Parallel.CloseGroup(group);
+            return ParallelHandle();
         }
-        auto& asset = _assets[assetIdx];
 
-        // Check if already loading or loaded.
-        if (asset->State == AssetState::Loading || asset->State == AssetState::Loaded)
+        g_Parallel.AddJob(group, [this, assetIdx]()
         {
-            Log("Attempted to load already loading/loaded asset " + std::to_string(assetIdx) + ".", LogLevel::Warning, LogMode::Debug);
-            return GenerateReadyFuture();
-        }
+            ParseAsset(assetIdx);
+        });
+        g_Parallel.CloseGroup(group);
 
-        // Check if file is valid.
-        if (!std::filesystem::exists(asset->File))
-        {
-            Log("Attempted to load asset " + std::to_string(assetIdx) + " from invalid file '" + asset->File.string() + "'.", LogLevel::Error);
+        return group;
+    }
 
-            asset->State = AssetState::Error;
-            return GenerateReadyFuture();
+    ParallelHandle AssetManager::LoadAsset(const std::string& assetName)
+    {
+        // Check if asset exists.
+        auto it = _assetIdxs.find(assetName);
+        if (it == _assetIdxs.end())
+        {
+            Log("Attempted to load unregistered asset '" + assetName + "'.", LogLevel::Warning, LogMode::Debug);
+            return ParallelHandle();
         }
 
-        // Set loading state.
-        asset->State = AssetState::Loading;
-        _loadingCount++;
+        // Load asset by index.
+        const auto& [keyName, assetIdx] = *it;
+        return LoadAsset(assetIdx);
+    }
 
-        // Load asynchronously.
-        return g_Parallel.AddTask([&]()
+    Task<std::shared_ptr<Asset>> AssetManager::LoadAssetAsync(int assetIdx)
+    {
+        // Get asset.
+        if (assetIdx < 0 || assetIdx >= _assets.size())
         {
-            // Get parser function.
-            auto parserFuncIt = PARSER_FUNCS.find(asset->Type);
-            if (parserFuncIt == PARSER_FUNCS.end())
-            {
-                Log("Attempted to load asset " + std::to_string(assetIdx) + " with no parser function for asset type " + std::to_string((int)asset->Type) + ".",
-                    LogLevel::Error);
+            Log("Attempted to load invalid asset " + std::to_string(assetIdx) + ".", LogLevel::Warning, LogMode::Debug);
+            co_return nullptr;
+        }
+        auto asset = _assets[assetIdx];
 
-                asset->State = AssetState::Error;
-                _loadingCount--;
-                return;
-            }
-            const auto& parserFunc = parserFuncIt->second;
+        // Start load unless already loading or loaded. Checked here, since awaiting shared asset is expected.
+        if (asset->State != AssetState::Loading && asset->State != AssetState::Loaded)
+        {
+            LoadAsset(assetIdx);
+        }
 
-            // Parse asset data from file.
-            try
-            {
-                asset->Data  = parserFunc(asset->File);
-                asset->State = AssetState::Loaded;
-            }
-            catch (const std::exception& ex)
-            {
-                Log("Failed to parse file for asset " + std::to_string(assetIdx) + ": " + ex.what(), LogLevel::Error);
+        // Await in-flight load.
+        if (asset->State == AssetState::Loading)
+        {
+            co_await ResumeOnCompletion(asset->LoadHandle, ParallelPriority::Background);
+        }
 
-                asset->State = AssetState::Error;
-            }
-            _loadingCount--;
-        });
+        co_return asset;
     }
 
-    std::future<void> AssetManager::LoadAsset(const std::string& assetName)
+    Task<std::shared_ptr<Asset>> AssetManager::LoadAssetAsync(const std::string& assetName)
     {
         // Check if asset exists.
         auto it = _assetIdxs.find(assetName);
         if (it == _assetIdxs.end())
         {
             Log("Attempted to load unregistered asset '" + assetName + "'.", LogLevel::Warning, LogMode::Debug);
-            return GenerateReadyFuture();
+            co_return nullptr;
         }
 
         // Load asset by index.
         const auto& [keyName, assetIdx] = *it;
-        return LoadAsset(assetIdx);
+        co_return co_await LoadAssetAsync(assetIdx);
     }
 
     void AssetManager::UnloadAsset(int assetIdx)
@@ -238,4 +236,69 @@ namespace Silent::Assets
 
         Log("All assets unloaded.", LogLevel::Info, LogMode::Debug);
     }
+
+    bool AssetManager::BeginLoad(int assetIdx, const ParallelHandle& loadHandle)
+    {
+        // Get asset.
+        if (assetIdx < 0 || assetIdx >= _assets.size())
+        {
+            Log("Attempted to load invalid asset " + std::to_string(assetIdx) + ".", LogLevel::Warning, LogMode::Debug);
+            return false;
+        }
+        auto& asset = _assets[assetIdx];
+
+        // Check if already loading or loaded.
+        if (asset->State == AssetState::Loading || asset->State == AssetState::Loaded)
+        {
+            Log("Attempted to load already loading/loaded asset " + std::to_string(assetIdx) + ".", LogLevel::Warning, LogMode::Debug);
+            return false;
+        }
+
+        // Check if file is valid.
+        if (!std::filesystem::exists(asset->File))
+        {
+            Log("Attempted to load asset " + std::to_string(assetIdx) + " from invalid file '" + asset->File.string() + "'.", LogLevel::Error);
+
+            asset->State = AssetState::Error;
+            return false;
+        }
+
+        // Set loading state. Handle is published first, so awaiters seeing `Loading` find it.
+        asset->LoadHandle = loadHandle;
+        asset->State      = AssetState::Loading;
+        _loadingCount++;
+        return true;
+    }
+
+    void AssetManager::ParseAsset(int assetIdx)
+    {
+        auto& asset = _assets[assetIdx];
+
+        // Get parser function.
+        auto parserFuncIt = PARSER_FUNCS.find(asset->Type);
+        if (parserFuncIt == PARSER_FUNCS.end())
+        {
+            Log("Attempted to load asset " + std::to_string(assetIdx) + " with no parser function for asset type " + std::to_string((int)asset->Type) + ".",
+                LogLevel::Error);
+
+            asset->State = AssetState::Error;
+            _loadingCount--;
+            return;
+        }
+        const auto& parserFunc = parserFuncIt->second;
+
+        // Parse asset data from file.
+        try
+        {
+            asset->Data  = parserFunc(asset->File);
+            asset->State = AssetState::Loaded;
+        }
+        catch (const std::exception& ex)
+        {
+            Log("Failed to parse file for asset " + std::to_string(assetIdx) + ": " + ex.what(), LogLevel::Error);
+
+            asset->State = AssetState::Error;
+        }
+        _loadingCount--;
+    }
 }
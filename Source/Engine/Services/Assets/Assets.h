@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Utils/Parallel.h"
+#include "Utils/Task.h"
+
 namespace Silent::Assets
 {
     enum class AssetType
@@ -36,8 +39,9 @@ namespace Silent::Assets
         std::filesystem::path File = {};             // Absolute file path.
         uint64                Size = 0;              // Raw file size in bytes.
 
-        std::atomic<AssetState> State = AssetState::Unloaded; // Thread-safe load state.
-        std::shared_ptr<void>   Data  = nullptr;              // Parsed data.
+        std::atomic<AssetState> State      = AssetState::Unloaded; // Thread-safe load state.
+        std::shared_ptr<void>   Data       = nullptr;              // Parsed data.
+        Utils::ParallelHandle   LoadHandle = {};                   // Job group of latest load. Set before `State` becomes `Loading`.
     };
 
     class AssetManager
@@ -65,12 +69,23 @@ namespace Silent::Assets
 
         // Utilities
 
-        void              Initialize(const std::filesystem::path& assetsPath);
-        std::future<void> LoadAsset(int assetIdx);
-        std::future<void> LoadAsset(const std::string& assetName);
-        void              UnloadAsset(int assetIdx);
-        void              UnloadAsset(const std::string& assetName);
-        void              UnloadAllAssets();
+        void                  Initialize(const std::filesystem::path& assetsPath);
+        Utils::ParallelHandle LoadAsset(int assetIdx);
+        Utils::ParallelHandle LoadAsset(const std::string& assetName);
+        void                  UnloadAsset(int assetIdx);
+        void                  UnloadAsset(const std::string& assetName);
+        void                  UnloadAllAssets();
+
+        /** @brief Loads asset on background lane and resolves to it once loaded. Loaded or invalid assets resolve immediately.
+         * Already loading assets resolve once in-flight load finishes. Awaiting coroutine resumes on worker completing load. */
+        Utils::Task<std::shared_ptr<Asset>> LoadAssetAsync(int assetIdx);
+        Utils::Task<std::shared_ptr<Asset>> LoadAssetAsync(const std::string& assetName);
+
+    private:
+        // Helpers
+
+        bool BeginLoad(int assetIdx, const Utils::ParallelHandle& loadHandle);
+        void ParseAsset(int assetIdx);
     };
 
     template <typename T>
@@ -1,6 +1,10 @@
 #include "Framework.h"
 #include "Engine/Services/Assets/Parsers/Tim.h"
 
+#include "Utils/Parallel.h"
+
+using namespace Silent::Utils;
+
 namespace Silent::Assets
 {
     enum class BitsPerPixel
@@ -10,11 +14,21 @@ namespace Silent::Assets
         Bpp16
     };
 
+    /** @brief Writes RGBA components extracted from 16-bit color. */
+    static void WriteColor(uint16 color, uchar* out)
+    {
+        out[0] = (color & 0x1F)         << 3;   // B.
+        out[1] = ((color >> 5) & 0x1F)  << 3;   // G.
+        out[2] = ((color >> 10) & 0x1F) << 3;   // R.
+        out[3] = (color & 0x8000) ? 0 : 255;    // A.
+    }
+
     std::shared_ptr<void> ParseTim(const std::filesystem::path& filename)
     {
-        constexpr int HEADER_MAGIC  = 1 << 4;
-        constexpr int HAS_CLUT_FLAG = 1 << 3;
-        constexpr int BPP_MASK      = 0x7;
+        constexpr int HEADER_MAGIC   = 1 << 4;
+        constexpr int HAS_CLUT_FLAG  = 1 << 3;
+        constexpr int BPP_MASK       = 0x7;
+        constexpr int ROW_GRAIN_SIZE = 16;
 
         // Read file.
         auto file = std::ifstream(filename, std::ios::binary);
@@ -139,78 +153,51 @@ namespace Silent::Assets
             .Pixels     = std::vector<uchar>((res.x * res.y) * 4)
         };
 
-        // Read pixels.
-        for (int y = 0; y < res.y; y++)
+        // Read packed pixel data. Rows are stored in 16-bit units.
+        int  rowSize = imageW * 2;
+        auto data    = std::vector<uchar>(rowSize * imageH);
+        file.read((char*)data.data(), data.size());
+
+        // Decode rows in parallel.
+        ParallelFor(0, res.y, ROW_GRAIN_SIZE, [&](int y)
         {
-            for (int x = 0; x < res.x;)
+            const uchar* in  = &data[y * rowSize];
+            uchar*       out = &asset.Pixels[(y * res.x) * 4];
+            switch (bpp)
             {
-                switch (bpp)
+                default:
+                case BitsPerPixel::Bpp4:
                 {
-                    default:
-                    case BitsPerPixel::Bpp4:
+                    for (int x = 0; x < res.x; x += 2)
                     {
-                        // Read color data.
-                        uint8 byte = 0;
-                        file.read((char*)&byte, 1);
-
                         // Decode CLUT indices from byte.
-                        uint idx0 = byte & 0xF;
-                        uint idx1 = byte >> 4;
-
-                        for (int i = 0; i < 2 && x < res.x; i++, x++)
-                        {
-                            // Get color from CLUT.
-                            uint16 color = clut[(i == 0) ? idx0 : idx1];
-
-                            // Collect extracted RGBA components.
-                            uchar* out = &asset.Pixels[((y * res.x) + x) * 4];
-                            out[0]     = (color & 0x1F)         << 3;          // B.
-                            out[1]     = ((color >> 5) & 0x1F)  << 3;          // G.
-                            out[2]     = ((color >> 10) & 0x1F) << 3;          // R.
-                            out[3]     = (color & 0x8000) ? 0 : 255;           // A.
-                        }
-                        break;
+                        uchar byte = in[x / 2];
+                        WriteColor(clut[byte & 0xF], &out[x * 4]);
+                        WriteColor(clut[byte >> 4],  &out[(x + 1) * 4]);
                     }
+                    break;
+                }
 
-                    case BitsPerPixel::Bpp8:
+                case BitsPerPixel::Bpp8:
+                {
+                    for (int x = 0; x < res.x; x++)
                     {
-                        // Read color data.
-                        uint idx = 0;
-                        file.read((char*)&idx, 1);
-                        
-                        // Get color from CLUT.
-                        uint16 color = clut[idx];
-
-                        // Collect extracted RGBA components.
-                        uchar* out = &asset.Pixels[((y * res.x) + x) * 4];
-                        out[0]     = (color & 0x1F)         << 3;          // B.
-                        out[1]     = ((color >> 5) & 0x1F)  << 3;          // G.
-                        out[2]     = ((color >> 10) & 0x1F) << 3;          // R.
-                        out[3]     = (color & 0x8000) ? 0 : 255;           // A.
-
-                        x++;
-                        break;
+                        WriteColor(clut[in[x]], &out[x * 4]);
                     }
+                    break;
+                }
 
-                    case BitsPerPixel::Bpp16:
+                case BitsPerPixel::Bpp16:
+                {
+                    for (int x = 0; x < res.x; x++)
                     {
-                        // Read color.
-                        uint16 color = 0;
-                        file.read((char*)&color, 2);
-
-                        // Collect extracted RGBA components.
-                        uchar* out = &asset.Pixels[((y * res.x) + x) * 4];
-                        out[0]     = (color & 0x1F)         << 3;          // B.
-                        out[1]     = ((color >> 5) & 0x1F)  << 3;          // G.
-                        out[2]     = ((color >> 10) & 0x1F) << 3;          // R.
-                        out[3]     = (color & 0x8000) ? 0 : 255;           // A.
-
-                        x++;
-                        break;
+                        uint16 color = in[x * 2] | (in[(x * 2) + 1] << 8);
+                        WriteColor(color, &out[x * 4]);
                     }
+                    break;
                 }
             }
-        }
+        });
 
         return std::make_shared<TimAsset>(std::move(asset));
     }
@@ -29,6 +29,7 @@ namespace Silent::Services
 
     constexpr char SCREENSHOT_FILENAME_BASE[] = "Screenshot_";
     constexpr char OPTIONS_FILENAME[]         = "Options";
+    constexpr char PARALLEL_STATS_FILENAME[]  = "ParallelStats";
     
     constexpr char JSON_FILE_EXT[]     = ".json";
     constexpr char PNG_FILE_EXT[]      = ".png";
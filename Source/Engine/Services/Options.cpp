@@ -51,6 +51,9 @@ namespace Silent::Services
     constexpr char KEY_VIEW_MODE[]                                = "ViewMode";
     constexpr char KEY_ENABLE_TOASTS[]                            = "EnableToasts";
     constexpr char KEY_ENABLE_PARALLELISM[]                       = "EnableParallelism";
+    constexpr char KEY_PARALLEL_WORKER_COUNT[]                    = "ParallelWorkerCount";
+    constexpr char KEY_PARALLEL_RESERVED_CORE_MASK[]              = "ParallelReservedCoreMask";
+    constexpr char KEY_ENABLE_PARALLEL_AFFINITY[]                 = "EnableParallelAffinity";
 
     constexpr auto DEFAULT_WINDOWED_SIZE                            = Vector2i(800, 600);
     constexpr bool DEFAULT_ENABLE_MAXIMIZED                         = false;
@@ -82,6 +85,9 @@ namespace Silent::Services
     constexpr bool DEFAULT_DISABLE_AUTO_AIMING                      = false;
     constexpr auto DEFAULT_VIEW_MODE                                = ViewMode::Normal;
     constexpr bool DEFAULT_ENABLE_TOASTS                            = true;
+    constexpr int  DEFAULT_PARALLEL_WORKER_COUNT                    = 0;
+    constexpr auto DEFAULT_PARALLEL_RESERVED_CORE_MASK              = (uint64)0;
+    constexpr bool DEFAULT_ENABLE_PARALLEL_AFFINITY                 = false;
 
     void OptionsManager::SetDefaultGraphicsOptions()
     {
@@ -134,8 +140,11 @@ namespace Silent::Services
 
     void OptionsManager::SetDefaultSystemOptions()
     {
-        _options.EnableToasts      = DEFAULT_ENABLE_TOASTS;
-        _options.EnableParallelism = GetCoreCount() > 1;
+        _options.EnableToasts             = DEFAULT_ENABLE_TOASTS;
+        _options.EnableParallelism        = GetCoreCount() > 1;
+        _options.ParallelWorkerCount      = DEFAULT_PARALLEL_WORKER_COUNT;
+        _options.ParallelReservedCoreMask = DEFAULT_PARALLEL_RESERVED_CORE_MASK;
+        _options.EnableParallelAffinity   = DEFAULT_ENABLE_PARALLEL_AFFINITY;
     }
 
     void OptionsManager::Initialize()
@@ -298,9 +307,12 @@ namespace Silent::Services
         }
 
         // Load system options.
-        const auto& systemJson    = optionsJson[KEY_SYSTEM];
-        options.EnableToasts      = systemJson.value(KEY_ENABLE_TOASTS, DEFAULT_ENABLE_TOASTS);
-        options.EnableParallelism = systemJson.value(KEY_ENABLE_PARALLELISM, GetCoreCount() > 1);
+        const auto& systemJson           = optionsJson[KEY_SYSTEM];
+        options.EnableToasts             = systemJson.value(KEY_ENABLE_TOASTS, DEFAULT_ENABLE_TOASTS);
+        options.EnableParallelism        = systemJson.value(KEY_ENABLE_PARALLELISM, GetCoreCount() > 1);
+        options.ParallelWorkerCount      = systemJson.value(KEY_PARALLEL_WORKER_COUNT, DEFAULT_PARALLEL_WORKER_COUNT);
+        options.ParallelReservedCoreMask = systemJson.value(KEY_PARALLEL_RESERVED_CORE_MASK, DEFAULT_PARALLEL_RESERVED_CORE_MASK);
+        options.EnableParallelAffinity   = systemJson.value(KEY_ENABLE_PARALLEL_AFFINITY, DEFAULT_ENABLE_PARALLEL_AFFINITY);
 
         return options;
     }
@@ -396,7 +408,11 @@ namespace Silent::Services
             {
                 KEY_SYSTEM,
                 {
-                    { KEY_ENABLE_TOASTS, options.EnableToasts }
+                    { KEY_ENABLE_TOASTS,               options.EnableToasts },
+                    { KEY_ENABLE_PARALLELISM,          options.EnableParallelism },
+                    { KEY_PARALLEL_WORKER_COUNT,       options.ParallelWorkerCount },
+                    { KEY_PARALLEL_RESERVED_CORE_MASK, options.ParallelReservedCoreMask },
+                    { KEY_ENABLE_PARALLEL_AFFINITY,    options.EnableParallelAffinity }
                 }
             }
         };
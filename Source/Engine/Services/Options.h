@@ -10,6 +10,7 @@ namespace Silent::Services
     constexpr int SOUND_VOLUME_MAX      = 128;
     constexpr int BULLET_ADJUST_MIN     = 1;
     constexpr int BULLET_ADJUST_MAX     = 6;
+    constexpr int PARALLEL_WORKER_MAX   = 64;
     constexpr int MOUSE_SENSITIVITY_MAX = 20;
 
     enum class FrameRateType
@@ -139,8 +140,11 @@ namespace Silent::Services
 
         // System (user)
 
-        bool EnableToasts      = false; // Popup messages, e.g. "Gamepad connected", "Gamepad disconnected", etc.
-        bool EnableParallelism = false;
+        bool   EnableToasts             = false; // Popup messages, e.g. "Gamepad connected", "Gamepad disconnected", etc.
+        bool   EnableParallelism        = false;
+        int    ParallelWorkerCount      = 0;     // 0 = one worker per available core, minus one for main thread.
+        uint64 ParallelReservedCoreMask = 0;     // Bit per logical core kept free of workers, e.g. for render thread or OS.
+        bool   EnableParallelAffinity   = false; // Pin workers to available cores. Linux only.
     };
 
     class OptionsManager
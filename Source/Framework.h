@@ -8,9 +8,11 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <condition_variable>
+#include <coroutine>
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -23,9 +25,12 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <random>
+#include <semaphore>
 #include <set>
 #include <span>
 #include <stack>
@@ -36,6 +41,7 @@
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -77,6 +83,12 @@ using json = nlohmann::json;
 #include <SDL3/SDL_opengl_glext.h>
 #include <SDL3/SDL_vulkan.h>
 
+// SIMD
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define SIMD_SSE
+    #include <immintrin.h>
+#endif
+
 // spdlog
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
@@ -6,6 +6,7 @@
 #include "Math/Objects/BoundingSphere.h"
 #include "Math/Objects/Color.h"
 #include "Math/Objects/EulerAngles.h"
+#include "Math/Objects/Frustum.h"
 #include "Math/Objects/Matrix.h"
 #include "Math/Objects/OrientedBoundingBox.h"
 #include "Math/Objects/Ray.h"
@@ -0,0 +1,148 @@
+#include "Framework.h"
+#include "Math/Objects/Frustum.h"
+
+#include "Math/Constants.h"
+#include "Math/Objects/AxisAlignedBoundingBox.h"
+#include "Math/Objects/BoundingSphere.h"
+#include "Math/Objects/Matrix.h"
+#include "Math/Objects/OrientedBoundingBox.h"
+#include "Math/Objects/Vector3.h"
+
+namespace Silent::Math
+{
+    Frustum::Frustum(const Matrix& viewProjMat)
+    {
+        // Reference: Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix", 2001.
+        auto getRow = [&](int i)
+        {
+            return glm::vec4(viewProjMat[0][i], viewProjMat[1][i], viewProjMat[2][i], viewProjMat[3][i]);
+        };
+
+        // Clip space bounds `-w <= x, y, z <= w` give planes as sums and differences of matrix rows.
+        auto row0   = getRow(0);
+        auto row1   = getRow(1);
+        auto row2   = getRow(2);
+        auto row3   = getRow(3);
+        auto planes = std::array<glm::vec4, PLANE_COUNT>
+        {
+            row3 + row0,
+            row3 - row0,
+            row3 + row1,
+            row3 - row1,
+            row3 + row2,
+            row3 - row2
+        };
+
+        // Normalize.
+        for (int i = 0; (uint)i < PLANE_COUNT; i++)
+        {
+            auto  normal = Vector3(planes[i].x, planes[i].y, planes[i].z);
+            float length = normal.Length();
+
+            Normals[i]   = normal / length;
+            Distances[i] = planes[i].w / length;
+        }
+    }
+
+    bool Frustum::Intersects(const Vector3& point) const
+    {
+        for (int i = 0; (uint)i < PLANE_COUNT; i++)
+        {
+            if ((Vector3::Dot(Normals[i], point) + Distances[i]) < 0.0f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool Frustum::Intersects(const BoundingSphere& sphere) const
+    {
+        return Contains(sphere) != ContainmentType::None;
+    }
+
+    bool Frustum::Intersects(const AxisAlignedBoundingBox& aabb) const
+    {
+        return Contains(aabb) != ContainmentType::None;
+    }
+
+    bool Frustum::Intersects(const OrientedBoundingBox& obb) const
+    {
+        return Contains(obb) != ContainmentType::None;
+    }
+
+    ContainmentType Frustum::Contains(const Vector3& point) const
+    {
+        return Intersects(point) ? ContainmentType::Contains : ContainmentType::None;
+    }
+
+    ContainmentType Frustum::Contains(const BoundingSphere& sphere) const
+    {
+        auto radii = std::array<float, PLANE_COUNT>{};
+        radii.fill(sphere.Radius);
+        return Contains(sphere.Center, radii);
+    }
+
+    ContainmentType Frustum::Contains(const AxisAlignedBoundingBox& aabb) const
+    {
+        // Project extents onto plane normals.
+        auto radii = std::array<float, PLANE_COUNT>{};
+        for (int i = 0; (uint)i < PLANE_COUNT; i++)
+        {
+            radii[i] = Vector3::Dot(glm::abs(Normals[i]), aabb.Extents);
+        }
+
+        return Contains(aabb.Center, radii);
+    }
+
+    ContainmentType Frustum::Contains(const OrientedBoundingBox& obb) const
+    {
+        auto rotMat = obb.Rotation.ToRotationMatrix();
+
+        // Project rotated extents onto plane normals.
+        auto radii = std::array<float, PLANE_COUNT>{};
+        for (int i = 0; (uint)i < Vector3::AXIS_COUNT; i++)
+        {
+            auto axis = Vector3(rotMat[i].x, rotMat[i].y, rotMat[i].z);
+            for (int j = 0; (uint)j < PLANE_COUNT; j++)
+            {
+                radii[j] += std::abs(Vector3::Dot(Normals[j], axis)) * obb.Extents[i];
+            }
+        }
+
+        return Contains(obb.Center, radii);
+    }
+
+    bool Frustum::operator==(const Frustum& frustum) const
+    {
+        return Normals == frustum.Normals && Distances == frustum.Distances;
+    }
+
+    bool Frustum::operator!=(const Frustum& frustum) const
+    {
+        return !(*this == frustum);
+    }
+
+    ContainmentType Frustum::Contains(const Vector3& center, const std::array<float, PLANE_COUNT>& radii) const
+    {
+        bool isInside = true;
+        for (int i = 0; (uint)i < PLANE_COUNT; i++)
+        {
+            // Fully outside plane; culled. Conservative near frustum corners, where volume may lie outside two planes at once.
+            float dist = Vector3::Dot(Normals[i], center) + Distances[i];
+            if (dist < -radii[i])
+            {
+                return ContainmentType::None;
+            }
+
+            // Straddles plane.
+            if (dist < radii[i])
+            {
+                isInside = false;
+            }
+        }
+
+        return isInside ? ContainmentType::Contains : ContainmentType::Intersects;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Math/Objects/Vector3.h"
+
+namespace Silent::Math
+{
+    class      AxisAlignedBoundingBox;
+    class      BoundingSphere;
+    class      Matrix;
+    class      OrientedBoundingBox;
+    enum class ContainmentType;
+
+    /** @brief View volume bounded by 6 inward-facing planes. Point `p` is inside plane `i` if `Dot(Normals[i], p) + Distances[i] >= 0`. */
+    class Frustum
+    {
+    public:
+        // Constants
+
+        static constexpr uint PLANE_COUNT = 6;
+
+        // Fields
+
+        std::array<Vector3, PLANE_COUNT> Normals   = {}; // Unit normals. Order: left, right, bottom, top, near, far.
+        std::array<float, PLANE_COUNT>   Distances = {};
+
+        // Constructors
+
+        constexpr Frustum() = default;
+
+        /** @brief Extracts planes of view-projection matrix. Unit clip space depth is assumed to be -1 to 1; for 0 to 1 depth,
+         * near plane lies slightly behind true near plane, which stays conservative for culling. */
+        Frustum(const Matrix& viewProjMat);
+
+        // Inquirers
+
+        bool Intersects(const Vector3& point) const;
+        bool Intersects(const BoundingSphere& sphere) const;
+        bool Intersects(const AxisAlignedBoundingBox& aabb) const;
+        bool Intersects(const OrientedBoundingBox& obb) const;
+
+        ContainmentType Contains(const Vector3& point) const;
+        ContainmentType Contains(const BoundingSphere& sphere) const;
+        ContainmentType Contains(const AxisAlignedBoundingBox& aabb) const;
+        ContainmentType Contains(const OrientedBoundingBox& obb) const;
+
+        // Operators
+
+        bool     operator==(const Frustum& frustum) const;
+        bool     operator!=(const Frustum& frustum) const;
+        Frustum& operator=(const Frustum& frustum) = default;
+
+    private:
+        // Helpers
+
+        /** @brief Classifies volume with signed center distance and projected radius per plane. */
+        ContainmentType Contains(const Vector3& center, const std::array<float, PLANE_COUNT>& radii) const;
+    };
+}
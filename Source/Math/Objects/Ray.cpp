@@ -28,9 +28,13 @@ namespace Silent::Math
 
     std::optional<float> Ray::Intersects(const AxisAlignedBoundingBox& aabb) const
     {
-        auto invDir       = Vector3::One / Direction;
-        auto intersectMin = ((aabb.Center - aabb.Extents) - Origin) * invDir;
-        auto intersectMax = ((aabb.Center + aabb.Extents) - Origin) * invDir;
+        auto invDir  = Vector3::One / Direction;
+        auto slabMin = ((aabb.Center - aabb.Extents) - Origin) * invDir;
+        auto slabMax = ((aabb.Center + aabb.Extents) - Origin) * invDir;
+
+        // Order slab distances per axis, since negative direction components swap near and far planes.
+        auto intersectMin = Vector3::Min(slabMin, slabMax);
+        auto intersectMax = Vector3::Max(slabMin, slabMax);
 
         float nearIntersect = std::max({ intersectMin.x, intersectMin.y, intersectMin.z });
         float farIntersect  = std::min({ intersectMax.x, intersectMax.y, intersectMax.z });
@@ -2,10 +2,132 @@
 #include "Utils/BoundingVolumeHierarchy.h"
 
 #include "Math/Math.h"
+#include "Utils/Parallel.h"
+
 using namespace Silent::Math;
 
 namespace Silent::Utils
 {
+    // Scratch of ray packet traversal. Hit pairs of ray index and object ID.
+    static thread_local std::vector<std::pair<int, int>> PacketHits = {};
+
+    // Scratch of batched refit. Marks flag collected nodes and are cleared before each batch returns.
+    static thread_local std::vector<int>  RefitNodeIds   = {};
+    static thread_local std::vector<int>  RebuildNodeIds = {};
+    static thread_local std::vector<bool> RefitNodeMarks = {};
+
+    // Scratch of optimizer sibling search. Heap of pairs of induced cost and node ID.
+    static thread_local std::vector<std::pair<float, int>> SiblingCandidates = {};
+
+    // Scratch of broadphase task descent.
+    static thread_local std::vector<std::pair<int, int>> PairNodeStack = {};
+
+    // Interleaves 10 bits of each normalized coordinate into 30-bit Morton code.
+    static uint GetMortonCode(const Vector3& normPos)
+    {
+        constexpr float AXIS_RES = 1024.0f;
+
+        auto expandBits = [](uint val)
+        {
+            val = (val * 0x00010001u) & 0xFF0000FFu;
+            val = (val * 0x00000101u) & 0x0F00F00Fu;
+            val = (val * 0x00000011u) & 0xC30C30C3u;
+            val = (val * 0x00000005u) & 0x49249249u;
+            return val;
+        };
+
+        uint x = (uint)std::clamp(normPos.x * AXIS_RES, 0.0f, AXIS_RES - 1.0f);
+        uint y = (uint)std::clamp(normPos.y * AXIS_RES, 0.0f, AXIS_RES - 1.0f);
+        uint z = (uint)std::clamp(normPos.z * AXIS_RES, 0.0f, AXIS_RES - 1.0f);
+        return (expandBits(x) << 2) | (expandBits(y) << 1) | expandBits(z);
+    }
+
+    // Sorts keys by Morton code in upper 32 bits with stable parallel LSD radix sort.
+    // Chunks build digit histograms in parallel, then scatter to offsets ordered by digit, then chunk, which keeps each pass stable.
+    static void SortMortonKeys(std::vector<uint64>& keys)
+    {
+        constexpr uint RADIX_BITS = 8;
+        constexpr uint RADIX_SIZE = 1 << RADIX_BITS;
+        constexpr uint PASS_COUNT = 4;
+        constexpr uint CHUNK_SIZE = 4096;
+
+        uint keyCount   = (uint)keys.size();
+        uint chunkCount = (keyCount + (CHUNK_SIZE - 1)) / CHUNK_SIZE;
+
+        // HEAP ALLOC: Scatter target and histogram per chunk.
+        auto sortedKeys = std::vector<uint64>(keyCount);
+        auto histograms = std::vector<std::array<uint, RADIX_SIZE>>(chunkCount);
+        for (int pass = 0; (uint)pass < PASS_COUNT; pass++)
+        {
+            int  shift    = 32 + (pass * RADIX_BITS);
+            auto getDigit = [&](uint64 key)
+            {
+                return (uint)(key >> shift) & (RADIX_SIZE - 1);
+            };
+
+            // Count digits per chunk.
+            ParallelFor(0, (int)chunkCount, 1, [&](int chunkIdx)
+            {
+                auto& histogram = histograms[chunkIdx];
+                histogram.fill(0);
+
+                uint end = std::min((chunkIdx + 1) * CHUNK_SIZE, keyCount);
+                for (uint i = chunkIdx * CHUNK_SIZE; i < end; i++)
+                {
+                    histogram[getDigit(keys[i])]++;
+                }
+            });
+
+            // Convert counts to scatter offsets. Skip pass if all keys share one digit.
+            uint offset    = 0;
+            bool isUniform = false;
+            for (int digit = 0; (uint)digit < RADIX_SIZE; digit++)
+            {
+                uint digitStart = offset;
+                for (auto& histogram : histograms)
+                {
+                    uint count        = histogram[digit];
+                    histogram[digit]  = offset;
+                    offset           += count;
+                }
+
+                if ((offset - digitStart) == keyCount)
+                {
+                    isUniform = true;
+                }
+            }
+
+            if (isUniform)
+            {
+                continue;
+            }
+
+            // Scatter keys in order within each chunk.
+            ParallelFor(0, (int)chunkCount, 1, [&](int chunkIdx)
+            {
+                auto& histogram = histograms[chunkIdx];
+
+                uint end = std::min((chunkIdx + 1) * CHUNK_SIZE, keyCount);
+                for (uint i = chunkIdx * CHUNK_SIZE; i < end; i++)
+                {
+                    sortedKeys[histogram[getDigit(keys[i])]++] = keys[i];
+                }
+            });
+
+            keys.swap(sortedKeys);
+        }
+    }
+
+    uint BvhQueryResults::GetQueryCount() const
+    {
+        return Offsets.empty() ? 0 : ((uint)Offsets.size() - 1);
+    }
+
+    std::span<const int> BvhQueryResults::GetObjectIds(uint queryIdx) const
+    {
+        return std::span(ObjectIds).subspan(Offsets[queryIdx], Offsets[queryIdx + 1] - Offsets[queryIdx]);
+    }
+
     bool BoundingVolumeHierarchy::Node::IsLeaf() const
     {
         return LeftChildId == NO_VALUE && RightChildId == NO_VALUE;
@@ -22,24 +144,81 @@ namespace Silent::Utils
         Build(objectIds, aabbs, strategy);
     }
 
+    BoundingVolumeHierarchy::BoundingVolumeHierarchy(std::span<const std::byte> blob)
+    {
+        if (!IsBlobValid(blob))
+        {
+            Log("BVH: Attempted to view invalid serialized tree.", LogLevel::Warning);
+            return;
+        }
+
+        const auto& header = *(const BlobHeader*)blob.data();
+        const auto* nodes  = blob.data() + sizeof(BlobHeader);
+        if ((BvhNodeFormat)header.NodeFormat == BvhNodeFormat::Quantized)
+        {
+            _mappedNodes.QuantizedNodes = std::span((const QuantizedNode*)nodes, header.NodeCount);
+        }
+        else
+        {
+            _mappedNodes.WideNodes = std::span((const WideNode*)nodes, header.NodeCount);
+        }
+
+        _nodeFormat        = (BvhNodeFormat)header.NodeFormat;
+        _mappedObjectCount = header.ObjectCount;
+        _isWideDirty       = false;
+    }
+
     uint BoundingVolumeHierarchy::GetSize() const
     {
-        return (uint)_leafIdMap.size();
+        return _mappedNodes.IsEmpty() ? (uint)_leafIdMap.size() : _mappedObjectCount;
+    }
+
+    BvhNodeFormat BoundingVolumeHierarchy::GetNodeFormat() const
+    {
+        return _nodeFormat;
+    }
+
+    uint64 BoundingVolumeHierarchy::GetCompiledByteSize() const
+    {
+        Compile();
+        auto queryNodes = GetQueryNodes();
+        return queryNodes.WideNodes.size_bytes() + queryNodes.QuantizedNodes.size_bytes();
     }
 
     std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds() const
     {
         auto objectIds = std::vector<int>{};
-        if (_leafIdMap.empty())
+        if (IsEmpty())
+        {
+            return objectIds;
+        }
+
+        // Serialized tree; collect object IDs of leaf lanes.
+        objectIds.reserve(GetSize());
+        if (!_mappedNodes.IsEmpty())
         {
+            auto decodedNode = WideNode{};
+            for (int i = 0; (uint)i < _mappedNodes.GetCount(); i++)
+            {
+                for (int objectId : _mappedNodes.GetNode(i, decodedNode).ObjectIds)
+                {
+                    if (objectId != NO_VALUE)
+                    {
+                        objectIds.push_back(objectId);
+                    }
+                }
+            }
+
             return objectIds;
         }
 
-        // Collect all object IDs.
-        objectIds.reserve(_leafIdMap.size());
-        for (const auto& [keyObjectId, leafId] : _leafIdMap)
+        // Collect object IDs of leaves. Free and inner nodes store no object ID.
+        for (const auto& node : _nodes)
         {
-            objectIds.push_back(keyObjectId);
+            if (node.ObjectId != NO_VALUE)
+            {
+                objectIds.push_back(node.ObjectId);
+            }
         }
 
         return objectIds;
@@ -47,64 +226,352 @@ namespace Silent::Utils
 
     std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds(const Ray& ray, float dist) const
     {
-        auto testColl = [&](const Node& node)
+        auto objectIds = std::vector<int>{};
+        Query(ray, dist, [&](int objectId)
         {
-            auto intersectDist = ray.Intersects(node.Aabb);
-            if (!intersectDist.has_value())
-            {
-                return false;
-            }
-            
-            return *intersectDist <= dist;
-        };
+            objectIds.push_back(objectId);
+        });
 
-        return GetBoundedObjectIds(testColl);
+        return objectIds;
     }
 
     std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds(const AxisAlignedBoundingBox& aabb) const
     {
-        auto testColl = [&](const Node& node)
+        auto objectIds = std::vector<int>{};
+        Query(aabb, [&](int objectId)
         {
-            return node.Aabb.Intersects(aabb);
-        };
+            objectIds.push_back(objectId);
+        });
 
-        return GetBoundedObjectIds(testColl);
+        return objectIds;
     }
 
     std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds(const OrientedBoundingBox& obb) const
     {
-        auto testColl = [&](const Node& node)
+        auto objectIds = std::vector<int>{};
+        Query(obb, [&](int objectId)
         {
-            return node.Aabb.Intersects(obb);
-        };
+            objectIds.push_back(objectId);
+        });
+
+        return objectIds;
+    }
+
+    std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds(const Frustum& frustum) const
+    {
+        auto objectIds = std::vector<int>{};
+        Query(frustum, [&](int objectId)
+        {
+            objectIds.push_back(objectId);
+        });
 
-        return GetBoundedObjectIds(testColl);
+        return objectIds;
     }
 
     std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds(const BoundingSphere& sphere) const
     {
-        auto testColl = [&](const Node& node)
+        auto objectIds = std::vector<int>{};
+        Query(sphere, [&](int objectId)
         {
-            return node.Aabb.Intersects(sphere);
-        };
+            objectIds.push_back(objectId);
+        });
+
+        return objectIds;
+    }
+
+    uint BoundingVolumeHierarchy::GetBoundedObjectIds(std::span<int> objectIds, const Ray& ray, float dist) const
+    {
+        if (objectIds.empty())
+        {
+            return 0;
+        }
+
+        uint count = 0;
+        Query(ray, dist, [&](int objectId)
+        {
+            objectIds[count++] = objectId;
+            return count < objectIds.size();
+        });
+
+        return count;
+    }
+
+    uint BoundingVolumeHierarchy::GetBoundedObjectIds(std::span<int> objectIds, const BoundingSphere& sphere) const
+    {
+        if (objectIds.empty())
+        {
+            return 0;
+        }
+
+        uint count = 0;
+        Query(sphere, [&](int objectId)
+        {
+            objectIds[count++] = objectId;
+            return count < objectIds.size();
+        });
+
+        return count;
+    }
+
+    uint BoundingVolumeHierarchy::GetBoundedObjectIds(std::span<int> objectIds, const AxisAlignedBoundingBox& aabb) const
+    {
+        if (objectIds.empty())
+        {
+            return 0;
+        }
+
+        uint count = 0;
+        Query(aabb, [&](int objectId)
+        {
+            objectIds[count++] = objectId;
+            return count < objectIds.size();
+        });
+
+        return count;
+    }
+
+    uint BoundingVolumeHierarchy::GetBoundedObjectIds(std::span<int> objectIds, const OrientedBoundingBox& obb) const
+    {
+        if (objectIds.empty())
+        {
+            return 0;
+        }
+
+        uint count = 0;
+        Query(obb, [&](int objectId)
+        {
+            objectIds[count++] = objectId;
+            return count < objectIds.size();
+        });
+
+        return count;
+    }
+
+    uint BoundingVolumeHierarchy::GetBoundedObjectIds(std::span<int> objectIds, const Frustum& frustum) const
+    {
+        if (objectIds.empty())
+        {
+            return 0;
+        }
+
+        uint count = 0;
+        Query(frustum, [&](int objectId)
+        {
+            objectIds[count++] = objectId;
+            return count < objectIds.size();
+        });
+
+        return count;
+    }
+
+    void BoundingVolumeHierarchy::GetBoundedObjectIds(BvhQueryResults& results, std::span<const Ray> rays, float dist) const
+    {
+        GetBatchResults(results, (uint)rays.size(), [&](uint start, uint end, std::vector<int>& objectIds, std::span<uint> counts)
+        {
+            for (uint packetStart = start; packetStart < end; packetStart += RAY_PACKET_SIZE_MAX)
+            {
+                uint packetSize = std::min(RAY_PACKET_SIZE_MAX, end - packetStart);
+                TraceRayPacket(rays.subspan(packetStart, packetSize), dist, objectIds, counts.subspan(packetStart - start, packetSize));
+            }
+        });
+    }
+
+    void BoundingVolumeHierarchy::GetBoundedObjectIds(BvhQueryResults& results, std::span<const BoundingSphere> spheres) const
+    {
+        GetBatchResults(results, (uint)spheres.size(), [&](uint start, uint end, std::vector<int>& objectIds, std::span<uint> counts)
+        {
+            for (int i = start; (uint)i < end; i++)
+            {
+                uint prevSize = (uint)objectIds.size();
+                Query(spheres[i], [&](int objectId)
+                {
+                    objectIds.push_back(objectId);
+                });
+
+                counts[i - start] = (uint)objectIds.size() - prevSize;
+            }
+        });
+    }
+
+    void BoundingVolumeHierarchy::GetBoundedObjectIds(BvhQueryResults& results, std::span<const AxisAlignedBoundingBox> aabbs) const
+    {
+        GetBatchResults(results, (uint)aabbs.size(), [&](uint start, uint end, std::vector<int>& objectIds, std::span<uint> counts)
+        {
+            for (int i = start; (uint)i < end; i++)
+            {
+                uint prevSize = (uint)objectIds.size();
+                Query(aabbs[i], [&](int objectId)
+                {
+                    objectIds.push_back(objectId);
+                });
+
+                counts[i - start] = (uint)objectIds.size() - prevSize;
+            }
+        });
+    }
+
+    void BoundingVolumeHierarchy::GetOverlappingPairs(BvhPairResults& results) const
+    {
+        GetPairs(results, *this);
+    }
+
+    void BoundingVolumeHierarchy::GetOverlappingPairs(BvhPairResults& results, const BoundingVolumeHierarchy& bvh) const
+    {
+        GetPairs(results, bvh);
+    }
+
+    BvhHandle BoundingVolumeHierarchy::GetHandle(int objectId) const
+    {
+        auto it = _leafIdMap.find(objectId);
+        if (it == _leafIdMap.end())
+        {
+            return BvhHandle{};
+        }
+
+        int leafId = it->second;
+        return BvhHandle{ leafId, _nodes[leafId].Generation };
+    }
+
+    BvhQualityMetrics BoundingVolumeHierarchy::GetQualityMetrics() const
+    {
+        auto metrics = BvhQualityMetrics{};
+        if (_rootId == NO_VALUE)
+        {
+            return metrics;
+        }
+
+        // Accumulate inner node and child overlap areas in one pass over node array. Free nodes store neither object ID nor children.
+        float innerArea   = 0.0f;
+        float overlapArea = 0.0f;
+        for (const auto& node : _nodes)
+        {
+            if (node.ObjectId != NO_VALUE)
+            {
+                metrics.LeafCount++;
+                continue;
+            }
+            else if (node.LeftChildId == NO_VALUE || node.RightChildId == NO_VALUE)
+            {
+                continue;
+            }
+
+            metrics.InnerCount++;
+            innerArea += node.Aabb.GetSurfaceArea();
+
+            // Add overlap of children.
+            const auto& leftChild  = _nodes[node.LeftChildId];
+            const auto& rightChild = _nodes[node.RightChildId];
+
+            auto overlapMin = Vector3::Max(leftChild.Aabb.GetMin(), rightChild.Aabb.GetMin());
+            auto overlapMax = Vector3::Min(leftChild.Aabb.GetMax(), rightChild.Aabb.GetMax());
+            auto overlap    = overlapMax - overlapMin;
+            if (overlap.x > 0.0f && overlap.y > 0.0f && overlap.z > 0.0f)
+            {
+                overlapArea += ((overlap.x * overlap.y) + (overlap.y * overlap.z) + (overlap.z * overlap.x)) * 2.0f;
+            }
+        }
+
+        // Normalize by root area.
+        const auto& root     = _nodes[_rootId];
+        float       rootArea = root.Aabb.GetSurfaceArea();
+        metrics.Height = root.Height;
+        if (rootArea > EPSILON)
+        {
+            metrics.SahCost     = innerArea / rootArea;
+            metrics.OverlapCost = overlapArea / rootArea;
+        }
+
+        return metrics;
+    }
+
+    std::optional<BvhNeighbor> BoundingVolumeHierarchy::GetNearestNeighbor(const Vector3& point, float maxDist) const
+    {
+        return GetNearestNeighbor(point, maxDist, [](int objectId)
+        {
+            return true;
+        });
+    }
+
+    std::vector<BvhNeighbor> BoundingVolumeHierarchy::GetNearestNeighbors(const Vector3& point, uint count, float maxDist) const
+    {
+        auto neighbors = std::vector<BvhNeighbor>(count);
+        neighbors.resize(GetNearestNeighbors(neighbors, point, maxDist, [](int objectId)
+        {
+            return true;
+        }));
+
+        return neighbors;
+    }
+
+    void BoundingVolumeHierarchy::SetNodeFormat(BvhNodeFormat format)
+    {
+        // FAILSAFE: Serialized tree is read-only.
+        if (!_mappedNodes.IsEmpty())
+        {
+            Log("BVH: Attempted to set node format of serialized tree.", LogLevel::Warning, LogMode::Debug, true);
+            return;
+        }
 
-        return GetBoundedObjectIds(testColl);
+        if (_nodeFormat != format)
+        {
+            _nodeFormat  = format;
+            _isWideDirty = true;
+        }
     }
 
     bool BoundingVolumeHierarchy::IsEmpty() const
     {
-        return _leafIdMap.empty();
+        return GetSize() == 0;
+    }
+
+    bool BoundingVolumeHierarchy::IsValid(const BvhHandle& handle) const
+    {
+        return GetLeafId(handle) != NO_VALUE;
+    }
+
+    bool BoundingVolumeHierarchy::IsBlobValid(std::span<const std::byte> blob)
+    {
+        if (blob.size() < sizeof(BlobHeader) || ((uintptr_t)blob.data() % alignof(WideNode)) != 0)
+        {
+            return false;
+        }
+
+        const auto& header   = *(const BlobHeader*)blob.data();
+        size_t      nodeSize = 0;
+        switch ((BvhNodeFormat)header.NodeFormat)
+        {
+            case BvhNodeFormat::Full:
+                nodeSize = sizeof(WideNode);
+                break;
+
+            case BvhNodeFormat::Quantized:
+                nodeSize = sizeof(QuantizedNode);
+                break;
+
+            default:
+                return false;
+        }
+
+        return header.Magic == BLOB_MAGIC && header.Version == BLOB_VERSION && header.NodeSize == nodeSize &&
+               blob.size() >= (sizeof(BlobHeader) + ((size_t)header.NodeCount * nodeSize));
     }
 
-    void BoundingVolumeHierarchy::Insert(int objectId, const AxisAlignedBoundingBox& aabb, float boundary)
+    BvhHandle BoundingVolumeHierarchy::Insert(int objectId, const AxisAlignedBoundingBox& aabb, float boundary)
     {
+        // FAILSAFE: Serialized tree is read-only.
+        if (!_mappedNodes.IsEmpty())
+        {
+            Log("BVH: Attempted to insert leaf into serialized tree.", LogLevel::Warning, LogMode::Debug, true);
+            return BvhHandle{};
+        }
+
         // FAILSAFE: Find leaf containing object ID.
         auto it = _leafIdMap.find(objectId);
         if (it != _leafIdMap.end())
         {
             Log("BVH: Attempted to insert leaf with existing object ID " + std::to_string(objectId) + ".",
                 LogLevel::Warning, LogMode::Debug, true);
-            return;
+            return BvhHandle{};
         }
 
         // Allocate new leaf.
@@ -112,12 +579,18 @@ namespace Silent::Utils
         auto& leaf  = _nodes[leafId];
 
         // Set initial parameters.
-        leaf.ObjectId = objectId;
-        leaf.Aabb     = AxisAlignedBoundingBox(aabb.Center, aabb.Extents + Vector3(boundary));
-        leaf.Height   = 0;
+        leaf.ObjectId   = objectId;
+        leaf.Aabb       = AxisAlignedBoundingBox(aabb.Center, aabb.Extents + Vector3(boundary));
+        leaf.Height     = 0;
+        leaf.Generation = _nextGeneration++;
 
         // Insert new leaf.
+        auto handle = BvhHandle{ leafId, leaf.Generation };
         InsertLeaf(leafId);
+
+        // Store object-leaf association.
+        _leafIdMap.insert({ objectId, leafId });
+        return handle;
     }
 
     void BoundingVolumeHierarchy::Move(int objectId, const AxisAlignedBoundingBox& aabb, float boundary)
@@ -131,28 +604,21 @@ namespace Silent::Utils
             return;
         }
 
-        // Get leaf.
+        // Move leaf.
         const auto& [keyObjectId, leafId] = *it;
-        auto& leaf = _nodes[leafId];
+        MoveLeaf(leafId, aabb, boundary);
+    }
 
-        // Test if object AABB is inside node AABB.
-        if (leaf.Aabb.Contains(aabb) == ContainmentType::Contains)
+    void BoundingVolumeHierarchy::Move(const BvhHandle& handle, const AxisAlignedBoundingBox& aabb, float boundary)
+    {
+        int leafId = GetLeafId(handle);
+        if (leafId == NO_VALUE)
         {
-            auto  deltaExtents = leaf.Aabb.Extents - aabb.Extents;
-            float threshold    = boundary * 2;
-
-            // Test if object AABB is significantly smaller than node AABB.
-            if (deltaExtents.x < threshold &&
-                deltaExtents.y < threshold &&
-                deltaExtents.z < threshold)
-            {
-                return;
-            }
+            Log("BVH: Attempted to move leaf with stale handle.", LogLevel::Warning, LogMode::Debug, true);
+            return;
         }
 
-        // Reinsert leaf.
-        RemoveLeaf(leafId);
-        Insert(objectId, aabb, boundary);
+        MoveLeaf(leafId, aabb, boundary);
     }
 
     void BoundingVolumeHierarchy::Remove(int objectId)
@@ -167,61 +633,1338 @@ namespace Silent::Utils
         }
 
         // Remove leaf.
-        const auto& [keyObjectId, leafId] = *it;
+        int leafId = it->second;
         RemoveLeaf(leafId);
+        RemoveNode(leafId);
     }
 
-    std::vector<int> BoundingVolumeHierarchy::GetBoundedObjectIds(const std::function<bool(const Node& node)>& testCollRoutine) const
+    void BoundingVolumeHierarchy::Remove(const BvhHandle& handle)
     {
-        auto objectIds = std::vector<int>{};
-        if (_nodes.empty())
+        int leafId = GetLeafId(handle);
+        if (leafId == NO_VALUE)
         {
-            return objectIds;
+            Log("BVH: Attempted to remove leaf with stale handle.", LogLevel::Warning, LogMode::Debug, true);
+            return;
+        }
+
+        RemoveLeaf(leafId);
+        RemoveNode(leafId);
+    }
+
+    void BoundingVolumeHierarchy::Move(std::span<const int> objectIds, std::span<const AxisAlignedBoundingBox> aabbs, float boundary)
+    {
+        Assert(objectIds.size() == aabbs.size(), "BVH: Object ID and AABB counts unequal in batched move.");
+
+        // Update leaf AABBs.
+        for (int i = 0; i < objectIds.size(); i++)
+        {
+            auto it = _leafIdMap.find(objectIds[i]);
+            if (it == _leafIdMap.end())
+            {
+                Log("BVH: Attempted to move missing leaf with object ID " + std::to_string(objectIds[i]) + ".",
+                    LogLevel::Warning, LogMode::Debug, true);
+                continue;
+            }
+
+            MarkRefitLeaf(it->second, aabbs[i], boundary);
+        }
+
+        // Refit ancestors.
+        RefitMarkedNodes();
+    }
+
+    void BoundingVolumeHierarchy::Move(std::span<const BvhHandle> handles, std::span<const AxisAlignedBoundingBox> aabbs, float boundary)
+    {
+        Assert(handles.size() == aabbs.size(), "BVH: Handle and AABB counts unequal in batched move.");
+
+        // Update leaf AABBs.
+        for (int i = 0; i < handles.size(); i++)
+        {
+            int leafId = GetLeafId(handles[i]);
+            if (leafId == NO_VALUE)
+            {
+                Log("BVH: Attempted to move leaf with stale handle.", LogLevel::Warning, LogMode::Debug, true);
+                continue;
+            }
+
+            MarkRefitLeaf(leafId, aabbs[i], boundary);
+        }
+
+        // Refit ancestors.
+        RefitMarkedNodes();
+    }
+
+    void BoundingVolumeHierarchy::Optimize(uint64 budgetMicrosec)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        auto budget    = std::chrono::microseconds(budgetMicrosec);
+
+        // Scan windows of node array from cursor and reinsert worst node of each, until budget elapses or all nodes are scanned once.
+        uint scanCount = 0;
+        while (_rootId != NO_VALUE && scanCount < _nodes.size() && (std::chrono::steady_clock::now() - startTime) < budget)
+        {
+            int   worstNodeId = NO_VALUE;
+            float worstCost   = 0.0f;
+            for (int i = 0; (uint)i < OPTIMIZE_SCAN_COUNT && scanCount < _nodes.size(); i++, scanCount++)
+            {
+                _optimizeCursor = (_optimizeCursor + 1) % (uint)_nodes.size();
+
+                // Skip root, leaves, and free nodes.
+                const auto& node = _nodes[_optimizeCursor];
+                if ((int)_optimizeCursor == _rootId || node.LeftChildId == NO_VALUE || node.RightChildId == NO_VALUE)
+                {
+                    continue;
+                }
+
+                float cost = GetNodeInefficiency(_optimizeCursor);
+                if (cost > worstCost)
+                {
+                    worstNodeId = _optimizeCursor;
+                    worstCost   = cost;
+                }
+            }
+
+            if (worstNodeId != NO_VALUE)
+            {
+                ReinsertNode(worstNodeId);
+            }
+        }
+    }
+
+    std::vector<std::byte> BoundingVolumeHierarchy::Serialize() const
+    {
+        static_assert(std::is_trivially_copyable_v<WideNode> && std::is_trivially_copyable_v<QuantizedNode>,
+                      "BVH: Compiled nodes must be trivially copyable to serialize.");
+
+        Compile();
+        auto queryNodes  = GetQueryNodes();
+        bool isQuantized = (_nodeFormat == BvhNodeFormat::Quantized);
+        auto header      = BlobHeader
+        {
+            .Magic       = BLOB_MAGIC,
+            .Version     = BLOB_VERSION,
+            .NodeFormat  = (uint32)_nodeFormat,
+            .NodeSize    = isQuantized ? (uint32)sizeof(QuantizedNode) : (uint32)sizeof(WideNode),
+            .NodeCount   = queryNodes.GetCount(),
+            .ObjectCount = GetSize()
+        };
+
+        // Write header followed by compiled nodes.
+        const auto* nodes    = isQuantized ? (const void*)queryNodes.QuantizedNodes.data() : (const void*)queryNodes.WideNodes.data();
+        size_t      nodeSize = isQuantized ? queryNodes.QuantizedNodes.size_bytes() : queryNodes.WideNodes.size_bytes();
+        auto        blob     = std::vector<std::byte>(sizeof(BlobHeader) + nodeSize);
+        std::memcpy(blob.data(), &header, sizeof(BlobHeader));
+        if (nodeSize != 0)
+        {
+            std::memcpy(blob.data() + sizeof(BlobHeader), nodes, nodeSize);
+        }
+
+        return blob;
+    }
+
+    void BoundingVolumeHierarchy::Compile() const
+    {
+        if (!_isWideDirty)
+        {
+            return;
+        }
+
+        // Collapse tree from root.
+        _wideNodes.clear();
+        _quantizedNodes.clear();
+        if (_rootId != NO_VALUE)
+        {
+            _wideNodes.reserve((_leafIdMap.size() / 2) + 1);
+            CompileNode(_rootId);
+        }
+
+        // Quantize and release full nodes. Node IDs are shared, so lanes link unchanged.
+        if (_nodeFormat == BvhNodeFormat::Quantized)
+        {
+            // HEAP ALLOC: Quantized form is allocated on compile, and full form is freed to keep memory savings.
+            _quantizedNodes.resize(_wideNodes.size());
+            for (int i = 0; (uint)i < _wideNodes.size(); i++)
+            {
+                _quantizedNodes[i] = QuantizeNode(_wideNodes[i]);
+            }
+
+            _wideNodes = {};
+        }
+
+        _isWideDirty = false;
+    }
+
+    BoundingVolumeHierarchy::QueryNodes BoundingVolumeHierarchy::GetQueryNodes() const
+    {
+        if (!_mappedNodes.IsEmpty())
+        {
+            return _mappedNodes;
+        }
+
+        // Compiled form is current; traverse it.
+        if (!_isWideDirty)
+        {
+            return QueryNodes
+            {
+                .WideNodes      = _wideNodes,
+                .QuantizedNodes = _quantizedNodes
+            };
+        }
+
+        // Compiled form is stale; traverse binary tree until next compile, so queries between modifications stay O(log n) without recompiling.
+        if (_rootId == NO_VALUE)
+        {
+            return QueryNodes{};
+        }
+
+        return QueryNodes
+        {
+            .BinaryNodes = _nodes,
+            .RootId      = _rootId
+        };
+    }
+
+    BoundingVolumeHierarchy::QuantizedNode BoundingVolumeHierarchy::QuantizeNode(const WideNode& wideNode)
+    {
+        constexpr int   EXPONENT_MIN = -126;
+        constexpr int   EXPONENT_MAX = 127;
+        constexpr uint8 GRID_MAX     = std::numeric_limits<uint8>::max();
+
+        // Dequantized value. Shared with `DecodeNode` so outward rounding checks match decoded bounds exactly.
+        auto dequantize = [](float origin, float step, uint8 value)
+        {
+            return origin + ((float)value * step);
+        };
+
+        auto node = QuantizedNode{};
+        node.MinX.fill(GRID_MAX);
+        node.MinY.fill(GRID_MAX);
+        node.MinZ.fill(GRID_MAX);
+
+        // Gather lanes with children.
+        auto min = Vector3(INFINITY);
+        auto max = Vector3(-INFINITY);
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            if (wideNode.MinX[i] > wideNode.MaxX[i])
+            {
+                node.ChildIds[i] = NO_VALUE;
+                continue;
+            }
+
+            bool isLeaf       = (wideNode.ObjectIds[i] != NO_VALUE);
+            node.ChildMask   |= 1 << i;
+            node.LeafMask    |= isLeaf ? (1 << i) : 0;
+            node.ChildIds[i]  = isLeaf ? wideNode.ObjectIds[i] : wideNode.ChildIds[i];
+            min               = Vector3::Min(min, Vector3(wideNode.MinX[i], wideNode.MinY[i], wideNode.MinZ[i]));
+            max               = Vector3::Max(max, Vector3(wideNode.MaxX[i], wideNode.MaxY[i], wideNode.MaxZ[i]));
+        }
+
+        if (node.ChildMask == 0)
+        {
+            return node;
+        }
+
+        // Quantize each axis on grid of 255 power-of-2 steps from min corner.
+        auto quantizeAxis = [&](int axis, const WideNode::Lanes& mins, const WideNode::Lanes& maxs, QuantizedNode::Lanes& quantMins, QuantizedNode::Lanes& quantMaxs)
+        {
+            // Find smallest step whose grid spans node bounds.
+            float origin   = min[axis];
+            int   exponent = 0;
+            std::frexp((max[axis] - origin) / GRID_MAX, &exponent);
+            exponent = std::clamp(exponent, EXPONENT_MIN, EXPONENT_MAX);
+            while (exponent < EXPONENT_MAX && dequantize(origin, std::ldexp(1.0f, exponent), GRID_MAX) < max[axis])
+            {
+                exponent++;
+            }
+
+            float step           = std::ldexp(1.0f, exponent);
+            node.Origin[axis]    = origin;
+            node.Exponents[axis] = (int8)exponent;
+
+            // Round child bounds outward.
+            for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+            {
+                if (!(node.ChildMask & (1 << i)))
+                {
+                    continue;
+                }
+
+                int quantMin = std::clamp((int)std::floor((mins[i] - origin) / step), 0, (int)GRID_MAX);
+                int quantMax = std::clamp((int)std::ceil((maxs[i] - origin) / step), 0, (int)GRID_MAX);
+                while (quantMin > 0 && dequantize(origin, step, quantMin) > mins[i])
+                {
+                    quantMin--;
+                }
+                while (quantMax < GRID_MAX && dequantize(origin, step, quantMax) < maxs[i])
+                {
+                    quantMax++;
+                }
+
+                quantMins[i] = (uint8)quantMin;
+                quantMaxs[i] = (uint8)quantMax;
+            }
+        };
+
+        quantizeAxis(0, wideNode.MinX, wideNode.MaxX, node.MinX, node.MaxX);
+        quantizeAxis(1, wideNode.MinY, wideNode.MaxY, node.MinY, node.MaxY);
+        quantizeAxis(2, wideNode.MinZ, wideNode.MaxZ, node.MinZ, node.MaxZ);
+        return node;
+    }
+
+    void BoundingVolumeHierarchy::DecodeNode(const QuantizedNode& quantizedNode, WideNode& wideNode)
+    {
+        // Power-of-2 step from biased exponent bits.
+        auto getStep = [](int8 exponent)
+        {
+            return std::bit_cast<float>((uint32)(exponent + 127) << 23);
+        };
+
+#ifdef SIMD_SSE
+        // Widen 4 8-bit values to floats and scale onto grid.
+        auto decodeAxis = [](const QuantizedNode::Lanes& values, float origin, float step, WideNode::Lanes& bounds)
+        {
+            int  packed = 0;
+            auto zero   = _mm_setzero_si128();
+            std::memcpy(&packed, values.data(), sizeof(packed));
+            auto values4 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero));
+            _mm_store_ps(bounds.data(), _mm_add_ps(_mm_set1_ps(origin), _mm_mul_ps(values4, _mm_set1_ps(step))));
+        };
+#else
+        auto decodeAxis = [](const QuantizedNode::Lanes& values, float origin, float step, WideNode::Lanes& bounds)
+        {
+            for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+            {
+                bounds[i] = origin + ((float)values[i] * step);
+            }
+        };
+#endif
+
+        float stepX = getStep(quantizedNode.Exponents[0]);
+        float stepY = getStep(quantizedNode.Exponents[1]);
+        float stepZ = getStep(quantizedNode.Exponents[2]);
+        decodeAxis(quantizedNode.MinX, quantizedNode.Origin[0], stepX, wideNode.MinX);
+        decodeAxis(quantizedNode.MinY, quantizedNode.Origin[1], stepY, wideNode.MinY);
+        decodeAxis(quantizedNode.MinZ, quantizedNode.Origin[2], stepZ, wideNode.MinZ);
+        decodeAxis(quantizedNode.MaxX, quantizedNode.Origin[0], stepX, wideNode.MaxX);
+        decodeAxis(quantizedNode.MaxY, quantizedNode.Origin[1], stepY, wideNode.MaxY);
+        decodeAxis(quantizedNode.MaxZ, quantizedNode.Origin[2], stepZ, wideNode.MaxZ);
+
+        // Split child references. Empty lanes get infinite inverted bounds, as in full nodes, so distance tests reject them too.
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            if (!(quantizedNode.ChildMask & (1 << i)))
+            {
+                wideNode.MinX[i]      = INFINITY;
+                wideNode.MinY[i]      = INFINITY;
+                wideNode.MinZ[i]      = INFINITY;
+                wideNode.MaxX[i]      = -INFINITY;
+                wideNode.MaxY[i]      = -INFINITY;
+                wideNode.MaxZ[i]      = -INFINITY;
+                wideNode.ChildIds[i]  = NO_VALUE;
+                wideNode.ObjectIds[i] = NO_VALUE;
+                continue;
+            }
+
+            bool isLeaf           = quantizedNode.LeafMask & (1 << i);
+            wideNode.ChildIds[i]  = isLeaf ? NO_VALUE : quantizedNode.ChildIds[i];
+            wideNode.ObjectIds[i] = isLeaf ? quantizedNode.ChildIds[i] : NO_VALUE;
+        }
+    }
+
+    uint BoundingVolumeHierarchy::QueryNodes::GetCount() const
+    {
+        return (uint)(WideNodes.size() + QuantizedNodes.size());
+    }
+
+    bool BoundingVolumeHierarchy::QueryNodes::IsEmpty() const
+    {
+        return WideNodes.empty() && QuantizedNodes.empty() && BinaryNodes.empty();
+    }
+
+    const BoundingVolumeHierarchy::WideNode& BoundingVolumeHierarchy::QueryNodes::GetNode(int nodeId, WideNode& decodedNode) const
+    {
+        if (!QuantizedNodes.empty())
+        {
+            DecodeNode(QuantizedNodes[nodeId], decodedNode);
+            return decodedNode;
+        }
+
+        if (BinaryNodes.empty())
+        {
+            return WideNodes[nodeId];
+        }
+
+        // View binary node as wide node with children in first lanes. Leaf root is viewed as its own single lane.
+        decodedNode.MinX.fill(INFINITY);
+        decodedNode.MinY.fill(INFINITY);
+        decodedNode.MinZ.fill(INFINITY);
+        decodedNode.MaxX.fill(-INFINITY);
+        decodedNode.MaxY.fill(-INFINITY);
+        decodedNode.MaxZ.fill(-INFINITY);
+        decodedNode.ChildIds.fill(NO_VALUE);
+        decodedNode.ObjectIds.fill(NO_VALUE);
+
+        const auto& node      = BinaryNodes[nodeId];
+        auto        childIds  = node.IsLeaf() ? std::array<int, 2>{ nodeId, NO_VALUE } : std::array<int, 2>{ node.LeftChildId, node.RightChildId };
+        uint        laneCount = 0;
+        for (int childId : childIds)
+        {
+            if (childId == NO_VALUE)
+            {
+                continue;
+            }
+
+            const auto& child   = BinaryNodes[childId];
+            auto        min     = child.Aabb.GetMin();
+            auto        max     = child.Aabb.GetMax();
+            int         laneIdx = laneCount++;
+
+            decodedNode.MinX[laneIdx]      = min.x;
+            decodedNode.MinY[laneIdx]      = min.y;
+            decodedNode.MinZ[laneIdx]      = min.z;
+            decodedNode.MaxX[laneIdx]      = max.x;
+            decodedNode.MaxY[laneIdx]      = max.y;
+            decodedNode.MaxZ[laneIdx]      = max.z;
+            decodedNode.ChildIds[laneIdx]  = child.IsLeaf() ? NO_VALUE : childId;
+            decodedNode.ObjectIds[laneIdx] = child.ObjectId;
         }
 
-        // Traverse tree.
-        auto nodeIds = std::stack<int>{};
-        nodeIds.push(_rootId);
-        while (!nodeIds.empty())
+        return decodedNode;
+    }
+
+    uint BoundingVolumeHierarchy::TestWideNode(const WideNode& wideNode, const Vector3& rayOrigin, const Vector3& rayInvDir, float dist, WideNode::Lanes& nearDists)
+    {
+#ifdef SIMD_SSE
+        // Slab test on 4 lanes.
+        auto testSlab = [](const float* mins, const float* maxs, float origin, float invDir, __m128& nearDist, __m128& farDist)
         {
-            int nodeId = nodeIds.top();
-            nodeIds.pop();
+            auto origin4 = _mm_set1_ps(origin);
+            auto invDir4 = _mm_set1_ps(invDir);
+            auto dist0   = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(mins), origin4), invDir4);
+            auto dist1   = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(maxs), origin4), invDir4);
+            nearDist     = _mm_max_ps(nearDist, _mm_min_ps(dist0, dist1));
+            farDist      = _mm_min_ps(farDist, _mm_max_ps(dist0, dist1));
+        };
 
-            // Invalid node; continue.
-            if (nodeId == NO_VALUE)
+        auto nearDist = _mm_set1_ps(-INFINITY);
+        auto farDist  = _mm_set1_ps(INFINITY);
+        testSlab(wideNode.MinX.data(), wideNode.MaxX.data(), rayOrigin.x, rayInvDir.x, nearDist, farDist);
+        testSlab(wideNode.MinY.data(), wideNode.MaxY.data(), rayOrigin.y, rayInvDir.y, nearDist, farDist);
+        testSlab(wideNode.MinZ.data(), wideNode.MaxZ.data(), rayOrigin.z, rayInvDir.z, nearDist, farDist);
+
+        // Hit if slabs overlap in front of origin and within distance. Empty lanes are rejected by inverted bounds.
+        auto isHit = _mm_and_ps(_mm_cmple_ps(nearDist, farDist), _mm_cmpge_ps(farDist, _mm_setzero_ps()));
+        isHit      = _mm_and_ps(isHit, _mm_cmple_ps(nearDist, _mm_set1_ps(dist)));
+        isHit      = _mm_and_ps(isHit, _mm_cmple_ps(_mm_load_ps(wideNode.MinX.data()), _mm_load_ps(wideNode.MaxX.data())));
+        _mm_storeu_ps(nearDists.data(), nearDist);
+        return (uint)_mm_movemask_ps(isHit);
+#else
+        uint laneMask = 0;
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            auto min = Vector3(wideNode.MinX[i], wideNode.MinY[i], wideNode.MinZ[i]);
+            auto max = Vector3(wideNode.MaxX[i], wideNode.MaxY[i], wideNode.MaxZ[i]);
+            if (min.x > max.x)
             {
                 continue;
             }
 
-            const auto& node = _nodes[nodeId];
+            auto  dist0    = (min - rayOrigin) * rayInvDir;
+            auto  dist1    = (max - rayOrigin) * rayInvDir;
+            auto  nearDist = Vector3::Min(dist0, dist1);
+            auto  farDist  = Vector3::Max(dist0, dist1);
+            float nearMax  = std::max({ nearDist.x, nearDist.y, nearDist.z });
+            float farMin   = std::min({ farDist.x, farDist.y, farDist.z });
+            nearDists[i]   = nearMax;
+            if (nearMax <= farMin && farMin >= 0.0f && nearMax <= dist)
+            {
+                laneMask |= 1 << i;
+            }
+        }
+
+        return laneMask;
+#endif
+    }
+
+    uint BoundingVolumeHierarchy::TestWideNode(const WideNode& wideNode, const AxisAlignedBoundingBox& aabb)
+    {
+        auto min = aabb.GetMin();
+        auto max = aabb.GetMax();
+
+#ifdef SIMD_SSE
+        auto isOverlap = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(wideNode.MinX.data()), _mm_set1_ps(max.x)),
+                                    _mm_cmpge_ps(_mm_load_ps(wideNode.MaxX.data()), _mm_set1_ps(min.x)));
+        isOverlap      = _mm_and_ps(isOverlap, _mm_cmple_ps(_mm_load_ps(wideNode.MinY.data()), _mm_set1_ps(max.y)));
+        isOverlap      = _mm_and_ps(isOverlap, _mm_cmpge_ps(_mm_load_ps(wideNode.MaxY.data()), _mm_set1_ps(min.y)));
+        isOverlap      = _mm_and_ps(isOverlap, _mm_cmple_ps(_mm_load_ps(wideNode.MinZ.data()), _mm_set1_ps(max.z)));
+        isOverlap      = _mm_and_ps(isOverlap, _mm_cmpge_ps(_mm_load_ps(wideNode.MaxZ.data()), _mm_set1_ps(min.z)));
+        return (uint)_mm_movemask_ps(isOverlap);
+#else
+        uint laneMask = 0;
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            if (wideNode.MinX[i] <= max.x && wideNode.MaxX[i] >= min.x &&
+                wideNode.MinY[i] <= max.y && wideNode.MaxY[i] >= min.y &&
+                wideNode.MinZ[i] <= max.z && wideNode.MaxZ[i] >= min.z)
+            {
+                laneMask |= 1 << i;
+            }
+        }
+
+        return laneMask;
+#endif
+    }
+
+    uint BoundingVolumeHierarchy::TestWideNode(const WideNode& wideNode, const BoundingSphere& sphere)
+    {
+#ifdef SIMD_SSE
+        // Squared distance from sphere center to closest point of each lane box.
+        auto getAxisDistSqr = [](const float* mins, const float* maxs, float center)
+        {
+            auto center4 = _mm_set1_ps(center);
+            auto closest = _mm_min_ps(_mm_max_ps(center4, _mm_load_ps(mins)), _mm_load_ps(maxs));
+            auto delta   = _mm_sub_ps(closest, center4);
+            return _mm_mul_ps(delta, delta);
+        };
+
+        auto distSqr = getAxisDistSqr(wideNode.MinX.data(), wideNode.MaxX.data(), sphere.Center.x);
+        distSqr      = _mm_add_ps(distSqr, getAxisDistSqr(wideNode.MinY.data(), wideNode.MaxY.data(), sphere.Center.y));
+        distSqr      = _mm_add_ps(distSqr, getAxisDistSqr(wideNode.MinZ.data(), wideNode.MaxZ.data(), sphere.Center.z));
+        return (uint)_mm_movemask_ps(_mm_cmple_ps(distSqr, _mm_set1_ps(SQUARE(sphere.Radius))));
+#else
+        uint laneMask = 0;
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            auto  min     = Vector3(wideNode.MinX[i], wideNode.MinY[i], wideNode.MinZ[i]);
+            auto  max     = Vector3(wideNode.MaxX[i], wideNode.MaxY[i], wideNode.MaxZ[i]);
+            auto  closest = Vector3::Min(Vector3::Max(sphere.Center, min), max);
+            float distSqr = Vector3::DistanceSquared(closest, sphere.Center);
+            if (distSqr <= SQUARE(sphere.Radius))
+            {
+                laneMask |= 1 << i;
+            }
+        }
+
+        return laneMask;
+#endif
+    }
+
+    uint BoundingVolumeHierarchy::TestWideNode(const WideNode& wideNode, const OrientedBoundingBox& obb)
+    {
+        // No SIMD path; test lanes individually.
+        uint laneMask = 0;
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            auto min = Vector3(wideNode.MinX[i], wideNode.MinY[i], wideNode.MinZ[i]);
+            auto max = Vector3(wideNode.MaxX[i], wideNode.MaxY[i], wideNode.MaxZ[i]);
+            if (min.x > max.x)
+            {
+                continue;
+            }
+
+            auto aabb = AxisAlignedBoundingBox((min + max) / 2.0f, (max - min) / 2.0f);
+            if (aabb.Intersects(obb))
+            {
+                laneMask |= 1 << i;
+            }
+        }
+
+        return laneMask;
+    }
+
+    uint BoundingVolumeHierarchy::TestWideNode(const WideNode& wideNode, const Vector3& point, float distSqrMax, WideNode::Lanes& distsSqr)
+    {
+#ifdef SIMD_SSE
+        // Squared distance from point to closest point of each lane box.
+        auto getAxisDistSqr = [](const float* mins, const float* maxs, float pos)
+        {
+            auto pos4    = _mm_set1_ps(pos);
+            auto closest = _mm_min_ps(_mm_max_ps(pos4, _mm_load_ps(mins)), _mm_load_ps(maxs));
+            auto delta   = _mm_sub_ps(closest, pos4);
+            return _mm_mul_ps(delta, delta);
+        };
+
+        auto distSqr = getAxisDistSqr(wideNode.MinX.data(), wideNode.MaxX.data(), point.x);
+        distSqr      = _mm_add_ps(distSqr, getAxisDistSqr(wideNode.MinY.data(), wideNode.MaxY.data(), point.y));
+        distSqr      = _mm_add_ps(distSqr, getAxisDistSqr(wideNode.MinZ.data(), wideNode.MaxZ.data(), point.z));
+        _mm_storeu_ps(distsSqr.data(), distSqr);
+
+        // Empty lanes are rejected by inverted bounds, as their infinite distance passes unbounded queries.
+        auto isNear = _mm_and_ps(_mm_cmple_ps(distSqr, _mm_set1_ps(distSqrMax)),
+                                 _mm_cmple_ps(_mm_load_ps(wideNode.MinX.data()), _mm_load_ps(wideNode.MaxX.data())));
+        return (uint)_mm_movemask_ps(isNear);
+#else
+        uint laneMask = 0;
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            auto min = Vector3(wideNode.MinX[i], wideNode.MinY[i], wideNode.MinZ[i]);
+            auto max = Vector3(wideNode.MaxX[i], wideNode.MaxY[i], wideNode.MaxZ[i]);
+            if (min.x > max.x)
+            {
+                continue;
+            }
+
+            auto closest = Vector3::Min(Vector3::Max(point, min), max);
+            distsSqr[i]  = Vector3::DistanceSquared(closest, point);
+            if (distsSqr[i] <= distSqrMax)
+            {
+                laneMask |= 1 << i;
+            }
+        }
+
+        return laneMask;
+#endif
+    }
+
+    uint BoundingVolumeHierarchy::TestWideNode(const WideNode& wideNode, const Frustum& frustum, uint planeMask, std::array<uint, WIDE_NODE_CHILD_COUNT>& lanePlaneMasks)
+    {
+        lanePlaneMasks.fill(0);
+
+#ifdef SIMD_SSE
+        // Doubled lane centers and extents.
+        auto minX    = _mm_load_ps(wideNode.MinX.data());
+        auto minY    = _mm_load_ps(wideNode.MinY.data());
+        auto minZ    = _mm_load_ps(wideNode.MinZ.data());
+        auto maxX    = _mm_load_ps(wideNode.MaxX.data());
+        auto maxY    = _mm_load_ps(wideNode.MaxY.data());
+        auto maxZ    = _mm_load_ps(wideNode.MaxZ.data());
+        auto centerX = _mm_add_ps(minX, maxX);
+        auto centerY = _mm_add_ps(minY, maxY);
+        auto centerZ = _mm_add_ps(minZ, maxZ);
+        auto extX    = _mm_sub_ps(maxX, minX);
+        auto extY    = _mm_sub_ps(maxY, minY);
+        auto extZ    = _mm_sub_ps(maxZ, minZ);
+
+        // Test 4 lanes per plane. Empty lanes are rejected by inverted bounds.
+        uint laneMask = (uint)_mm_movemask_ps(_mm_cmple_ps(minX, maxX));
+        while (planeMask != 0 && laneMask != 0)
+        {
+            int planeIdx = std::countr_zero(planeMask);
+            planeMask   &= planeMask - 1;
+
+            const auto& normal = frustum.Normals[planeIdx];
+            auto        dist   = _mm_mul_ps(centerX, _mm_set1_ps(normal.x));
+            dist               = _mm_add_ps(dist, _mm_mul_ps(centerY, _mm_set1_ps(normal.y)));
+            dist               = _mm_add_ps(dist, _mm_mul_ps(centerZ, _mm_set1_ps(normal.z)));
+            dist               = _mm_add_ps(dist, _mm_set1_ps(frustum.Distances[planeIdx] * 2.0f));
+            auto        radius = _mm_mul_ps(extX, _mm_set1_ps(std::abs(normal.x)));
+            radius             = _mm_add_ps(radius, _mm_mul_ps(extY, _mm_set1_ps(std::abs(normal.y))));
+            radius             = _mm_add_ps(radius, _mm_mul_ps(extZ, _mm_set1_ps(std::abs(normal.z))));
+
+            // Cull lanes fully outside plane, keep plane for lanes straddling it.
+            laneMask          &= ~(uint)_mm_movemask_ps(_mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), radius)));
+            uint straddleMask  = (uint)_mm_movemask_ps(_mm_cmplt_ps(dist, radius)) & laneMask;
+            while (straddleMask != 0)
+            {
+                lanePlaneMasks[std::countr_zero(straddleMask)] |= 1 << planeIdx;
+                straddleMask                                   &= straddleMask - 1;
+            }
+        }
+
+        return laneMask;
+#else
+        uint laneMask = 0;
+        for (int i = 0; (uint)i < WIDE_NODE_CHILD_COUNT; i++)
+        {
+            auto min = Vector3(wideNode.MinX[i], wideNode.MinY[i], wideNode.MinZ[i]);
+            auto max = Vector3(wideNode.MaxX[i], wideNode.MaxY[i], wideNode.MaxZ[i]);
+            if (min.x > max.x)
+            {
+                continue;
+            }
+
+            auto center   = (min + max) / 2.0f;
+            auto extents  = (max - min) / 2.0f;
+            bool isCulled = false;
+            for (uint lanePlaneMask = planeMask; lanePlaneMask != 0; lanePlaneMask &= lanePlaneMask - 1)
+            {
+                int   planeIdx = std::countr_zero(lanePlaneMask);
+                float dist     = Vector3::Dot(frustum.Normals[planeIdx], center) + frustum.Distances[planeIdx];
+                float radius   = Vector3::Dot(glm::abs(frustum.Normals[planeIdx]), extents);
+                if (dist < -radius)
+                {
+                    isCulled = true;
+                    break;
+                }
+
+                if (dist < radius)
+                {
+                    lanePlaneMasks[i] |= 1 << planeIdx;
+                }
+            }
+
+            if (!isCulled)
+            {
+                laneMask |= 1 << i;
+            }
+        }
+
+        return laneMask;
+#endif
+    }
+
+    void BoundingVolumeHierarchy::GetBatchResults(BvhQueryResults& results, uint queryCount,
+                                                  const std::function<void(uint start, uint end, std::vector<int>& objectIds, std::span<uint> counts)>& queryChunk) const
+    {
+        // Reset results.
+        uint chunkCount = (queryCount + (BATCH_CHUNK_SIZE - 1)) / BATCH_CHUNK_SIZE;
+        results.ObjectIds.clear();
+        results.Offsets.assign(queryCount + 1, 0);
+        if (results.ChunkObjectIds.size() < chunkCount)
+        {
+            // HEAP ALLOC: Chunk scratch grows when batch exceeds previous sizes.
+            results.ChunkObjectIds.resize(chunkCount);
+        }
+
+        // Run chunks in parallel. Result count of query `i` is written to `Offsets[i + 1]`.
+        ParallelFor(0, (int)chunkCount, 1, [&](int chunkIdx)
+        {
+            uint  start     = chunkIdx * BATCH_CHUNK_SIZE;
+            uint  end       = std::min(start + BATCH_CHUNK_SIZE, queryCount);
+            auto& objectIds = results.ChunkObjectIds[chunkIdx];
+
+            objectIds.clear();
+            queryChunk(start, end, objectIds, std::span(results.Offsets).subspan(start + 1, end - start));
+        });
+
+        // Convert counts to prefix offsets.
+        for (int i = 0; (uint)i < queryCount; i++)
+        {
+            results.Offsets[i + 1] += results.Offsets[i];
+        }
+
+        // Concatenate chunk results.
+        results.ObjectIds.resize(results.Offsets[queryCount]);
+        for (int i = 0; (uint)i < chunkCount; i++)
+        {
+            const auto& objectIds = results.ChunkObjectIds[i];
+            std::copy(objectIds.begin(), objectIds.end(), results.ObjectIds.begin() + results.Offsets[i * BATCH_CHUNK_SIZE]);
+        }
+    }
+
+    void BoundingVolumeHierarchy::TraceRayPacket(std::span<const Ray> rays, float dist, std::vector<int>& objectIds, std::span<uint> counts) const
+    {
+        using PacketLanes = std::array<float, RAY_PACKET_SIZE_MAX>;
+
+        auto queryNodes = GetQueryNodes();
+        if (queryNodes.IsEmpty())
+        {
+            std::fill(counts.begin(), counts.end(), 0);
+            return;
+        }
+
+        // Gather rays as SoA. Padding lanes stay masked out.
+        alignas(16) PacketLanes originX = {};
+        alignas(16) PacketLanes originY = {};
+        alignas(16) PacketLanes originZ = {};
+        alignas(16) PacketLanes invDirX = {};
+        alignas(16) PacketLanes invDirY = {};
+        alignas(16) PacketLanes invDirZ = {};
+        for (int i = 0; i < rays.size(); i++)
+        {
+            auto invDir = Vector3::One / rays[i].Direction;
+            originX[i]  = rays[i].Origin.x;
+            originY[i]  = rays[i].Origin.y;
+            originZ[i]  = rays[i].Origin.z;
+            invDirX[i]  = invDir.x;
+            invDirY[i]  = invDir.y;
+            invDirZ[i]  = invDir.z;
+        }
+
+        // Slab test of active rays against one child lane. Returns bit mask of hitting rays.
+        auto testLane = [&](const WideNode& wideNode, int laneIdx, uint rayMask)
+        {
+            uint hitMask = 0;
+#ifdef SIMD_SSE
+            auto minX = _mm_set1_ps(wideNode.MinX[laneIdx]);
+            auto minY = _mm_set1_ps(wideNode.MinY[laneIdx]);
+            auto minZ = _mm_set1_ps(wideNode.MinZ[laneIdx]);
+            auto maxX = _mm_set1_ps(wideNode.MaxX[laneIdx]);
+            auto maxY = _mm_set1_ps(wideNode.MaxY[laneIdx]);
+            auto maxZ = _mm_set1_ps(wideNode.MaxZ[laneIdx]);
+
+            // Test groups of 4 rays.
+            for (int i = 0; (uint)i < RAY_PACKET_SIZE_MAX; i += 4)
+            {
+                uint groupMask = (rayMask >> i) & 0xF;
+                if (groupMask == 0)
+                {
+                    continue;
+                }
+
+                auto nearDist = _mm_set1_ps(-INFINITY);
+                auto farDist  = _mm_set1_ps(INFINITY);
+                auto testSlab = [&](__m128 min, __m128 max, const float* origins, const float* invDirs)
+                {
+                    auto origin = _mm_load_ps(origins + i);
+                    auto invDir = _mm_load_ps(invDirs + i);
+                    auto dist0  = _mm_mul_ps(_mm_sub_ps(min, origin), invDir);
+                    auto dist1  = _mm_mul_ps(_mm_sub_ps(max, origin), invDir);
+                    nearDist    = _mm_max_ps(nearDist, _mm_min_ps(dist0, dist1));
+                    farDist     = _mm_min_ps(farDist, _mm_max_ps(dist0, dist1));
+                };
+
+                testSlab(minX, maxX, originX.data(), invDirX.data());
+                testSlab(minY, maxY, originY.data(), invDirY.data());
+                testSlab(minZ, maxZ, originZ.data(), invDirZ.data());
+
+                auto isHit = _mm_and_ps(_mm_cmple_ps(nearDist, farDist), _mm_cmpge_ps(farDist, _mm_setzero_ps()));
+                isHit      = _mm_and_ps(isHit, _mm_cmple_ps(nearDist, _mm_set1_ps(dist)));
+                hitMask   |= ((uint)_mm_movemask_ps(isHit) & groupMask) << i;
+            }
+#else
+            auto min = Vector3(wideNode.MinX[laneIdx], wideNode.MinY[laneIdx], wideNode.MinZ[laneIdx]);
+            auto max = Vector3(wideNode.MaxX[laneIdx], wideNode.MaxY[laneIdx], wideNode.MaxZ[laneIdx]);
+            while (rayMask != 0)
+            {
+                int i    = std::countr_zero(rayMask);
+                rayMask &= rayMask - 1;
+
+                auto  origin   = Vector3(originX[i], originY[i], originZ[i]);
+                auto  invDir   = Vector3(invDirX[i], invDirY[i], invDirZ[i]);
+                auto  dist0    = (min - origin) * invDir;
+                auto  dist1    = (max - origin) * invDir;
+                auto  nearDist = Vector3::Min(dist0, dist1);
+                auto  farDist  = Vector3::Max(dist0, dist1);
+                float nearMax  = std::max({ nearDist.x, nearDist.y, nearDist.z });
+                float farMin   = std::min({ farDist.x, farDist.y, farDist.z });
+                if (nearMax <= farMin && farMin >= 0.0f && nearMax <= dist)
+                {
+                    hitMask |= 1 << i;
+                }
+            }
+#endif
+            return hitMask;
+        };
+
+        // Traverse compiled tree once for whole packet, carrying mask of rays still active per node.
+        auto& hits        = PacketHits;
+        auto  decodedNode = WideNode{};
+        auto  stack       = TraversalStack<std::pair<int, uint>>{}; // First = wide node ID, second = active ray mask.
+        hits.clear();
+        stack.Push({ queryNodes.RootId, (1u << rays.size()) - 1 });
+        while (!stack.IsEmpty())
+        {
+            auto [wideNodeId, rayMask] = stack.Pop();
+            const auto& wideNode = queryNodes.GetNode(wideNodeId, decodedNode);
+
+            for (int laneIdx = 0; (uint)laneIdx < WIDE_NODE_CHILD_COUNT; laneIdx++)
+            {
+                // Empty lane; skip.
+                if (wideNode.MinX[laneIdx] > wideNode.MaxX[laneIdx])
+                {
+                    continue;
+                }
+
+                uint hitMask = testLane(wideNode, laneIdx, rayMask);
+                if (hitMask == 0)
+                {
+                    continue;
+                }
+
+                // Leaf child; record hit per ray.
+                if (wideNode.ObjectIds[laneIdx] != NO_VALUE)
+                {
+                    while (hitMask != 0)
+                    {
+                        int rayIdx = std::countr_zero(hitMask);
+                        hitMask   &= hitMask - 1;
+                        hits.push_back({ rayIdx, wideNode.ObjectIds[laneIdx] });
+                    }
+                }
+                // Inner child; push with rays that hit it.
+                else
+                {
+                    stack.Push({ wideNode.ChildIds[laneIdx], hitMask });
+                }
+            }
+        }
+
+        // Group hits by ray.
+        auto offsets = std::array<uint, RAY_PACKET_SIZE_MAX + 1>{};
+        for (const auto& [rayIdx, objectId] : hits)
+        {
+            offsets[rayIdx + 1]++;
+        }
+        for (int i = 0; i < rays.size(); i++)
+        {
+            counts[i]       = offsets[i + 1];
+            offsets[i + 1] += offsets[i];
+        }
+
+        uint baseIdx = (uint)objectIds.size();
+        objectIds.resize(baseIdx + hits.size());
+        for (const auto& [rayIdx, objectId] : hits)
+        {
+            objectIds[baseIdx + offsets[rayIdx]++] = objectId;
+        }
+    }
+
+    // Gets overlapping pairs between this and `bvh`. Self query if `bvh` is this tree.
+    void BoundingVolumeHierarchy::GetPairs(BvhPairResults& results, const BoundingVolumeHierarchy& bvh) const
+    {
+        results.Pairs.clear();
+        results.NodePairs.clear();
+        if (_rootId == NO_VALUE || bvh._rootId == NO_VALUE)
+        {
+            return;
+        }
+
+        // Expand root pair breadth-first on calling thread until there are enough subtree pairs to distribute.
+        auto& nodePairs = results.NodePairs;
+        uint  headIdx   = 0;
+        nodePairs.push_back({ _rootId, bvh._rootId });
+        while (headIdx < nodePairs.size() && (nodePairs.size() - headIdx) < PAIR_TASK_COUNT)
+        {
+            auto nodePair = nodePairs[headIdx++];
+            ExpandNodePair(bvh, nodePair, nodePairs, results.Pairs);
+        }
+
+        uint taskCount = (uint)nodePairs.size() - headIdx;
+        if (results.TaskPairs.size() < taskCount)
+        {
+            // HEAP ALLOC: Task scratch grows when more tasks are needed than in previous queries.
+            results.TaskPairs.resize(taskCount);
+        }
+
+        // Descend subtree pairs in parallel.
+        ParallelFor(0, (int)taskCount, 1, [&](int taskIdx)
+        {
+            auto& pairs     = results.TaskPairs[taskIdx];
+            auto& nodeStack = PairNodeStack;
+            pairs.clear();
+            nodeStack.clear();
+
+            nodeStack.push_back(nodePairs[headIdx + taskIdx]);
+            while (!nodeStack.empty())
+            {
+                auto nodePair = nodeStack.back();
+                nodeStack.pop_back();
+                ExpandNodePair(bvh, nodePair, nodeStack, pairs);
+            }
+        });
+
+        // Concatenate task results.
+        uint pairCount = (uint)results.Pairs.size();
+        for (int i = 0; (uint)i < taskCount; i++)
+        {
+            pairCount += (uint)results.TaskPairs[i].size();
+        }
+
+        results.Pairs.reserve(pairCount);
+        for (int i = 0; (uint)i < taskCount; i++)
+        {
+            const auto& pairs = results.TaskPairs[i];
+            results.Pairs.insert(results.Pairs.end(), pairs.begin(), pairs.end());
+        }
+    }
+
+    // Descends node pair one step. Overlapping leaf pairs are written to `pairs`, overlapping child pairs are pushed to `nodePairs`.
+    // Pair of node with itself in self query descends into both children and pair of them, so each object pair is reached once.
+    void BoundingVolumeHierarchy::ExpandNodePair(const BoundingVolumeHierarchy& bvh, const std::pair<int, int>& nodePair,
+                                                 std::vector<std::pair<int, int>>& nodePairs, std::vector<BvhObjectPair>& pairs) const
+    {
+        bool isSelf             = &bvh == this;
+        auto [nodeId0, nodeId1] = nodePair;
+        const auto& node0       = _nodes[nodeId0];
+        const auto& node1       = bvh._nodes[nodeId1];
+
+        // Self pair.
+        if (isSelf && nodeId0 == nodeId1)
+        {
+            if (!node0.IsLeaf())
+            {
+                nodePairs.push_back({ node0.LeftChildId,  node0.LeftChildId });
+                nodePairs.push_back({ node0.RightChildId, node0.RightChildId });
+                nodePairs.push_back({ node0.LeftChildId,  node0.RightChildId });
+            }
+
+            return;
+        }
+
+        if (!node0.Aabb.Intersects(node1.Aabb))
+        {
+            return;
+        }
+
+        // Leaf pair; write object pair.
+        if (node0.IsLeaf() && node1.IsLeaf())
+        {
+            if (isSelf)
+            {
+                pairs.push_back(BvhObjectPair{ std::min(node0.ObjectId, node1.ObjectId), std::max(node0.ObjectId, node1.ObjectId) });
+            }
+            else
+            {
+                pairs.push_back(BvhObjectPair{ node0.ObjectId, node1.ObjectId });
+            }
+
+            return;
+        }
+
+        // Descend into larger node.
+        if (node1.IsLeaf() || (!node0.IsLeaf() && node0.Aabb.GetSurfaceArea() >= node1.Aabb.GetSurfaceArea()))
+        {
+            nodePairs.push_back({ node0.LeftChildId,  nodeId1 });
+            nodePairs.push_back({ node0.RightChildId, nodeId1 });
+        }
+        else
+        {
+            nodePairs.push_back({ nodeId0, node1.LeftChildId });
+            nodePairs.push_back({ nodeId0, node1.RightChildId });
+        }
+    }
+
+    int BoundingVolumeHierarchy::CompileNode(int nodeId) const
+    {
+        // Gather up to 4 descendants by repeatedly opening inner node with largest surface area.
+        auto childIds   = std::array<int, WIDE_NODE_CHILD_COUNT>{};
+        uint childCount = 0;
+        childIds[childCount++] = nodeId;
+        while (childCount < WIDE_NODE_CHILD_COUNT)
+        {
+            int   openIdx  = NO_VALUE;
+            float openArea = -INFINITY;
+            for (int i = 0; (uint)i < childCount; i++)
+            {
+                const auto& child = _nodes[childIds[i]];
+                if (!child.IsLeaf() && child.Aabb.GetSurfaceArea() > openArea)
+                {
+                    openIdx  = i;
+                    openArea = child.Aabb.GetSurfaceArea();
+                }
+            }
+
+            if (openIdx == NO_VALUE)
+            {
+                break;
+            }
+
+            // Replace opened node with its children.
+            const auto& openNode = _nodes[childIds[openIdx]];
+            if (openNode.LeftChildId != NO_VALUE && openNode.RightChildId != NO_VALUE)
+            {
+                childIds[openIdx]      = openNode.LeftChildId;
+                childIds[childCount++] = openNode.RightChildId;
+            }
+            else
+            {
+                childIds[openIdx] = (openNode.LeftChildId != NO_VALUE) ? openNode.LeftChildId : openNode.RightChildId;
+            }
+        }
+
+        // Allocate wide node with empty lanes.
+        int   wideNodeId = (int)_wideNodes.size();
+        auto& wideNode   = _wideNodes.emplace_back();
+        wideNode.MinX.fill(INFINITY);
+        wideNode.MinY.fill(INFINITY);
+        wideNode.MinZ.fill(INFINITY);
+        wideNode.MaxX.fill(-INFINITY);
+        wideNode.MaxY.fill(-INFINITY);
+        wideNode.MaxZ.fill(-INFINITY);
+        wideNode.ChildIds.fill(NO_VALUE);
+        wideNode.ObjectIds.fill(NO_VALUE);
+
+        // Fill lanes.
+        for (int i = 0; (uint)i < childCount; i++)
+        {
+            const auto& child = _nodes[childIds[i]];
+            auto        min   = child.Aabb.GetMin();
+            auto        max   = child.Aabb.GetMax();
+
+            wideNode.MinX[i]      = min.x;
+            wideNode.MinY[i]      = min.y;
+            wideNode.MinZ[i]      = min.z;
+            wideNode.MaxX[i]      = max.x;
+            wideNode.MaxY[i]      = max.y;
+            wideNode.MaxZ[i]      = max.z;
+            wideNode.ObjectIds[i] = child.ObjectId;
+        }
+
+        // Compile inner children. Recursion may reallocate `_wideNodes`, so lanes are written by ID.
+        for (int i = 0; (uint)i < childCount; i++)
+        {
+            if (!_nodes[childIds[i]].IsLeaf())
+            {
+                int childWideNodeId = CompileNode(childIds[i]);
+                _wideNodes[wideNodeId].ChildIds[i] = childWideNodeId;
+            }
+        }
+
+        return wideNodeId;
+    }
+
+    void BoundingVolumeHierarchy::MoveLeaf(int leafId, const AxisAlignedBoundingBox& aabb, float boundary)
+    {
+        auto& leaf = _nodes[leafId];
+
+        // Test if leaf AABB still fits object AABB.
+        if (IsLeafAabbValid(leaf.Aabb, aabb, boundary))
+        {
+            return;
+        }
+
+        // Reinsert leaf. Leaf ID is kept, so handles stay valid.
+        RemoveLeaf(leafId);
+        leaf.Aabb = AxisAlignedBoundingBox(aabb.Center, aabb.Extents + Vector3(boundary));
+        InsertLeaf(leafId);
+    }
+
+    // Updates leaf AABB in place for batched refit and collects each ancestor once.
+    void BoundingVolumeHierarchy::MarkRefitLeaf(int leafId, const AxisAlignedBoundingBox& aabb, float boundary)
+    {
+        auto& nodeIds = RefitNodeIds;
+        auto& marks   = RefitNodeMarks;
+        if (marks.size() < _nodes.size())
+        {
+            // HEAP ALLOC: Marks grow with node count.
+            marks.resize(_nodes.size(), false);
+        }
+
+        auto& leaf = _nodes[leafId];
+        if (IsLeafAabbValid(leaf.Aabb, aabb, boundary))
+        {
+            return;
+        }
+
+        leaf.Aabb = AxisAlignedBoundingBox(aabb.Center, aabb.Extents + Vector3(boundary));
+
+        int nodeId = leaf.ParentId;
+        while (nodeId != NO_VALUE && !marks[nodeId])
+        {
+            marks[nodeId] = true;
+            nodeIds.push_back(nodeId);
+            nodeId = _nodes[nodeId].ParentId;
+        }
+    }
+
+    // Refits nodes collected by `MarkRefitLeaf` bottom-up and rebuilds degraded subtrees.
+    void BoundingVolumeHierarchy::RefitMarkedNodes()
+    {
+        auto& nodeIds        = RefitNodeIds;
+        auto& rebuildNodeIds = RebuildNodeIds;
+        auto& marks          = RefitNodeMarks;
+        rebuildNodeIds.clear();
+
+        if (nodeIds.empty())
+        {
+            return;
+        }
+
+        _isWideDirty = true;
+
+        // Refit bottom-up. Topology is unchanged and children are lower than parents, so sorting by height fits children first.
+        std::sort(nodeIds.begin(), nodeIds.end(), [&](int nodeId0, int nodeId1)
+        {
+            return _nodes[nodeId0].Height < _nodes[nodeId1].Height;
+        });
+
+        for (int nodeId : nodeIds)
+        {
+            auto& node = _nodes[nodeId];
+            marks[nodeId] = false;
+
+            // Record cost ratio before first refit.
+            float area = node.Aabb.GetSurfaceArea();
+            if (node.BaseCostRatio == 0.0f && area > EPSILON)
+            {
+                node.BaseCostRatio = node.Cost / area;
+            }
+
+            FitNode(nodeId);
+
+            // Collect degraded subtree.
+            area = node.Aabb.GetSurfaceArea();
+            if ((uint)node.Height >= REBUILD_HEIGHT_MIN && node.BaseCostRatio != 0.0f && area > EPSILON &&
+                (node.Cost / area) > (node.BaseCostRatio * REFIT_COST_RATIO_MAX))
+            {
+                rebuildNodeIds.push_back(nodeId);
+            }
+        }
+
+        // Rebuild degraded subtrees, highest first. Subtrees inside rebuilt subtree are skipped, since inner node IDs stay within subtree.
+        for (int i = (int)rebuildNodeIds.size() - 1; i >= 0; i--)
+        {
+            int  nodeId      = rebuildNodeIds[i];
+            bool isContained = false;
+            for (int ancestorId = nodeId; ancestorId != NO_VALUE; ancestorId = _nodes[ancestorId].ParentId)
+            {
+                if (marks[ancestorId])
+                {
+                    isContained = true;
+                    break;
+                }
+            }
+
+            if (isContained)
+            {
+                rebuildNodeIds[i] = NO_VALUE;
+                continue;
+            }
+
+            rebuildNodeIds[i]        = RebuildNode(nodeId);
+            marks[rebuildNodeIds[i]] = true;
+        }
+
+        // Clear marks.
+        for (int nodeId : rebuildNodeIds)
+        {
+            if (nodeId != NO_VALUE)
+            {
+                marks[nodeId] = false;
+            }
+        }
+
+        nodeIds.clear();
+    }
+
+    // Gets inefficiency of inner node: large nodes poorly covered by their children rank highest.
+    // Reference: Bittner et al., "Fast Insertion-Based Optimization of Bounding Volume Hierarchies", 2013.
+    float BoundingVolumeHierarchy::GetNodeInefficiency(int nodeId) const
+    {
+        const auto& node = _nodes[nodeId];
+
+        float area      = node.Aabb.GetSurfaceArea();
+        float leftArea  = _nodes[node.LeftChildId].Aabb.GetSurfaceArea();
+        float rightArea = _nodes[node.RightChildId].Aabb.GetSurfaceArea();
+
+        float sumRatio = area / std::max(leftArea + rightArea, EPSILON);
+        float minRatio = area / std::max(std::min(leftArea, rightArea), EPSILON);
+        return area * sumRatio * minRatio;
+    }
+
+    // Removes inner node and its parent, then reinserts both children as subtrees at best positions. Leaf IDs are kept.
+    void BoundingVolumeHierarchy::ReinsertNode(int nodeId)
+    {
+        int leftChildId  = _nodes[nodeId].LeftChildId;
+        int rightChildId = _nodes[nodeId].RightChildId;
+
+        // Detach node, collapsing parent, then free it.
+        RemoveLeaf(nodeId);
+        _nodes[leftChildId].ParentId  = NO_VALUE;
+        _nodes[rightChildId].ParentId = NO_VALUE;
+        RemoveNode(nodeId);
+
+        // Reinsert children.
+        InsertNode(leftChildId);
+        InsertNode(rightChildId);
+    }
+
+    // Inserts detached subtree next to sibling of lowest total cost, then refits ancestors with surface area heuristic rotations.
+    // Unlike `InsertLeaf`, which favors speed, sibling search is exhaustive branch and bound and ancestors are rotated for cost rather than height.
+    void BoundingVolumeHierarchy::InsertNode(int nodeId)
+    {
+        _isWideDirty = true;
+
+        // Create root if empty.
+        if (_rootId == NO_VALUE)
+        {
+            _rootId = nodeId;
+            return;
+        }
+
+        // Link new parent between sibling and its previous parent.
+        int siblingId    = GetBestSiblingId(nodeId);
+        int parentId     = GetNewNodeId();
+        int prevParentId = _nodes[siblingId].ParentId;
+
+        auto& parent = _nodes[parentId];
+        parent.ParentId            = prevParentId;
+        parent.LeftChildId         = siblingId;
+        parent.RightChildId        = nodeId;
+        _nodes[siblingId].ParentId = parentId;
+        _nodes[nodeId].ParentId    = parentId;
+        if (prevParentId == NO_VALUE)
+        {
+            _rootId = parentId;
+        }
+        else
+        {
+            auto& prevParent = _nodes[prevParentId];
+            ((prevParent.LeftChildId == siblingId) ? prevParent.LeftChildId : prevParent.RightChildId) = parentId;
+        }
+
+        // Refit and rotate ancestors.
+        for (int ancestorId = parentId; ancestorId != NO_VALUE; ancestorId = _nodes[ancestorId].ParentId)
+        {
+            FitNode(ancestorId);
+            RotateNode(ancestorId);
+        }
+    }
+
+    // Finds sibling minimizing total surface area added by insertion with branch and bound over induced ancestor growth.
+    // Reference: Bittner et al., "Fast Insertion-Based Optimization of Bounding Volume Hierarchies", 2013.
+    int BoundingVolumeHierarchy::GetBestSiblingId(int nodeId) const
+    {
+        auto& candidates = SiblingCandidates;
+        auto  compare    = [](const std::pair<float, int>& candidate0, const std::pair<float, int>& candidate1)
+        {
+            return candidate0.first > candidate1.first;
+        };
+
+        const auto& node     = _nodes[nodeId];
+        float       nodeArea = node.Aabb.GetSurfaceArea();
+        int         bestId   = _rootId;
+        float       bestCost = AxisAlignedBoundingBox::Merge(_nodes[_rootId].Aabb, node.Aabb).GetSurfaceArea();
+
+        // Visit candidates in order of cost induced on their ancestors.
+        candidates.clear();
+        candidates.push_back({ 0.0f, _rootId });
+        while (!candidates.empty())
+        {
+            std::pop_heap(candidates.begin(), candidates.end(), compare);
+            auto [inducedCost, candidateId] = candidates.back();
+            candidates.pop_back();
 
-            // Test node collision.
-            if (!testCollRoutine(node))
+            // Lower bound exceeds best; no remaining candidate can improve.
+            if ((inducedCost + nodeArea) >= bestCost)
             {
-                continue;
+                break;
             }
 
-            // Leaf node; collect object ID.
-            if (node.IsLeaf())
+            const auto& candidate  = _nodes[candidateId];
+            float       mergedArea = AxisAlignedBoundingBox::Merge(candidate.Aabb, node.Aabb).GetSurfaceArea();
+            float       cost       = inducedCost + mergedArea;
+            if (cost < bestCost)
             {
-                objectIds.push_back(node.ObjectId);
+                bestId   = candidateId;
+                bestCost = cost;
             }
-            // Inner node; push children onto stack for traversal.
-            else
-            {
-                if (node.LeftChildId != NO_VALUE)
-                {
-                    nodeIds.push(node.LeftChildId);
-                }
 
-                if (node.RightChildId != NO_VALUE)
+            // Descend if children could improve.
+            float childInducedCost = inducedCost + (mergedArea - candidate.Aabb.GetSurfaceArea());
+            if (!candidate.IsLeaf() && (childInducedCost + nodeArea) < bestCost)
+            {
+                for (int childId : { candidate.LeftChildId, candidate.RightChildId })
                 {
-                    nodeIds.push(node.RightChildId);
+                    if (childId != NO_VALUE)
+                    {
+                        candidates.push_back({ childInducedCost, childId });
+                        std::push_heap(candidates.begin(), candidates.end(), compare);
+                    }
                 }
             }
         }
 
-        return objectIds;
+        return bestId;
+    }
+
+    // Gets leaf ID of handle, or `NO_VALUE` if handle is stale.
+    int BoundingVolumeHierarchy::GetLeafId(const BvhHandle& handle) const
+    {
+        if (handle.LeafId < 0 || handle.LeafId >= _nodes.size())
+        {
+            return NO_VALUE;
+        }
+
+        const auto& leaf = _nodes[handle.LeafId];
+        if (handle.Generation == 0 || leaf.Generation != handle.Generation)
+        {
+            return NO_VALUE;
+        }
+
+        return handle.LeafId;
     }
 
     int BoundingVolumeHierarchy::GetNewNodeId()
@@ -229,16 +1972,19 @@ namespace Silent::Utils
         int nodeId = 0;
 
         // Allocate and get new empty node ID.
-        if (_freeNodeIds.empty())
+        if (_freeNodeId == NO_VALUE)
         {
             _nodes.emplace_back();
             nodeId = (int)_nodes.size() - 1;
         }
-        // Get existing empty node ID.
+        // Pop existing empty node ID from free list.
         else
         {
-            nodeId = _freeNodeIds.top();
-            _freeNodeIds.pop();
+            nodeId      = _freeNodeId;
+            _freeNodeId = _nodes[nodeId].ParentId;
+            _freeNodeCount--;
+
+            _nodes[nodeId].ParentId = NO_VALUE;
         }
 
         return nodeId;
@@ -305,12 +2051,11 @@ namespace Silent::Utils
 
     void BoundingVolumeHierarchy::InsertLeaf(int leafId)
     {
+        _isWideDirty = true;
+
         // Create root if empty.
         if (_rootId == NO_VALUE)
         {
-            auto& leaf = _nodes[leafId];
-
-            _leafIdMap.insert({ leaf.ObjectId, leafId });
             _rootId = leafId;
             return;
         }
@@ -361,9 +2106,6 @@ namespace Silent::Utils
         // Refit.
         RefitNode(leafId);
 
-        // Store object-leaf association.
-        _leafIdMap.insert({ leaf.ObjectId, leafId });
-
         //Validate(leafId);
     }
 
@@ -372,8 +2114,14 @@ namespace Silent::Utils
         int nodeId = leafId;
         int parentId = _nodes[nodeId].ParentId;
 
-        // Remove node.
-        RemoveNode(nodeId);
+        _isWideDirty = true;
+
+        // Detach leaf. Caller frees or reinserts it.
+        _nodes[nodeId].ParentId = NO_VALUE;
+        if (_rootId == nodeId)
+        {
+            _rootId = NO_VALUE;
+        }
 
         // Prune branch up to root.
         while (parentId != NO_VALUE)
@@ -436,32 +2184,40 @@ namespace Silent::Utils
         {
             // Balance node and get new subtree root.
             int newParentId = BalanceNode(parentId);
-            auto& parent = _nodes[newParentId];
+            FitNode(newParentId);
 
-            if (parent.LeftChildId != NO_VALUE && parent.RightChildId != NO_VALUE)
-            {
-                const auto& leftChild = _nodes[parent.LeftChildId];
-                const auto& rightChild = _nodes[parent.RightChildId];
+            parentId = _nodes[newParentId].ParentId;
+        }
+    }
 
-                parent.Aabb   = AxisAlignedBoundingBox::Merge(leftChild.Aabb, rightChild.Aabb);
-                parent.Height = std::max(leftChild.Height, rightChild.Height) + 1;
-            }
-            else if (parent.LeftChildId != NO_VALUE)
-            {
-                const auto& leftChild = _nodes[parent.LeftChildId];
+    // Fits AABB, height, and cost of inner node to its children.
+    void BoundingVolumeHierarchy::FitNode(int nodeId)
+    {
+        auto& node = _nodes[nodeId];
+        if (node.LeftChildId != NO_VALUE && node.RightChildId != NO_VALUE)
+        {
+            const auto& leftChild  = _nodes[node.LeftChildId];
+            const auto& rightChild = _nodes[node.RightChildId];
 
-                parent.Aabb   = leftChild.Aabb;
-                parent.Height = leftChild.Height + 1;
-            }
-            else if (parent.RightChildId != NO_VALUE)
-            {
-                const auto& rightChild = _nodes[parent.RightChildId];
+            node.Aabb   = AxisAlignedBoundingBox::Merge(leftChild.Aabb, rightChild.Aabb);
+            node.Height = std::max(leftChild.Height, rightChild.Height) + 1;
+            node.Cost   = node.Aabb.GetSurfaceArea() + leftChild.Cost + rightChild.Cost;
+        }
+        else if (node.LeftChildId != NO_VALUE)
+        {
+            const auto& leftChild = _nodes[node.LeftChildId];
 
-                parent.Aabb   = rightChild.Aabb;
-                parent.Height = rightChild.Height + 1;
-            }
+            node.Aabb   = leftChild.Aabb;
+            node.Height = leftChild.Height + 1;
+            node.Cost   = node.Aabb.GetSurfaceArea() + leftChild.Cost;
+        }
+        else if (node.RightChildId != NO_VALUE)
+        {
+            const auto& rightChild = _nodes[node.RightChildId];
 
-            parentId = parent.ParentId;
+            node.Aabb   = rightChild.Aabb;
+            node.Height = rightChild.Height + 1;
+            node.Cost   = node.Aabb.GetSurfaceArea() + rightChild.Cost;
         }
     }
 
@@ -475,15 +2231,130 @@ namespace Silent::Utils
             _leafIdMap.erase(node.ObjectId);
         }
 
-        // Clear node and mark free.
-        node = {};
-        _freeNodeIds.push(nodeId);
+        // Clear node and push to free list, linked through parent ID.
+        node          = {};
+        node.ParentId = _freeNodeId;
+        _freeNodeId   = nodeId;
+        _freeNodeCount++;
+
+        // Shrink capacity if empty to avoid memory bloat. Generation counter is kept, so stale handles stay invalid, and node format is kept.
+        if (_nodes.size() == _freeNodeCount)
+        {
+            uint nextGeneration = _nextGeneration;
+            auto nodeFormat     = _nodeFormat;
+            *this               = {};
+            _nextGeneration     = nextGeneration;
+            _nodeFormat         = nodeFormat;
+        }
+    }
+
+    // Rebuilds subtree with binned surface area heuristic into its existing nodes. Leaf IDs are kept. Returns new subtree root ID.
+    int BoundingVolumeHierarchy::RebuildNode(int nodeId)
+    {
+        // HEAP ALLOC: Collect leaves and inner nodes of subtree.
+        auto leafIds   = std::vector<int>{};
+        auto innerIds  = std::vector<int>{};
+        auto nodeStack = std::vector<int>{ nodeId };
+        while (!nodeStack.empty())
+        {
+            int childId = nodeStack.back();
+            nodeStack.pop_back();
+
+            const auto& child = _nodes[childId];
+            if (child.IsLeaf())
+            {
+                leafIds.push_back(childId);
+                continue;
+            }
+
+            innerIds.push_back(childId);
+            if (child.LeftChildId != NO_VALUE)
+            {
+                nodeStack.push_back(child.LeftChildId);
+            }
+            if (child.RightChildId != NO_VALUE)
+            {
+                nodeStack.push_back(child.RightChildId);
+            }
+        }
+
+        Assert(innerIds.size() == (leafIds.size() - 1), "BVH: Rebuilt subtree must have one fewer inner node than leaves.");
+
+        // Build into existing nodes.
+        auto aabbs   = std::vector<AxisAlignedBoundingBox>(leafIds.size());
+        auto primIds = std::vector<int>(leafIds.size());
+        for (int i = 0; i < leafIds.size(); i++)
+        {
+            aabbs[i] = _nodes[leafIds[i]].Aabb;
+        }
+        std::iota(primIds.begin(), primIds.end(), 0);
+
+        int parentId  = _nodes[nodeId].ParentId;
+        int newNodeId = BuildSubtree(aabbs, primIds, leafIds, innerIds);
+
+        // Link to parent.
+        _nodes[newNodeId].ParentId = parentId;
+        if (parentId == NO_VALUE)
+        {
+            _rootId = newNodeId;
+            return newNodeId;
+        }
+
+        auto& parent = _nodes[parentId];
+        ((parent.LeftChildId == nodeId) ? parent.LeftChildId : parent.RightChildId) = newNodeId;
+
+        // Refit ancestors, as height and cost changed.
+        for (int ancestorId = parentId; ancestorId != NO_VALUE; ancestorId = _nodes[ancestorId].ParentId)
+        {
+            FitNode(ancestorId);
+        }
+
+        return newNodeId;
+    }
+
+    // Builds subtree over `primIds` from leaves `leafIds[primId]`, taking inner node IDs from `innerIds`. Returns subtree root ID.
+    int BoundingVolumeHierarchy::BuildSubtree(const std::vector<AxisAlignedBoundingBox>& aabbs, std::span<int> primIds, std::span<const int> leafIds, std::vector<int>& innerIds)
+    {
+        // Leaf node.
+        if (primIds.size() == 1)
+        {
+            return leafIds[primIds.front()];
+        }
+
+        // Build children.
+        int split        = GetBinnedSplit(aabbs, primIds);
+        int leftChildId  = BuildSubtree(aabbs, primIds.first(split), leafIds, innerIds);
+        int rightChildId = BuildSubtree(aabbs, primIds.subspan(split), leafIds, innerIds);
+
+        // Create inner node.
+        int nodeId = innerIds.back();
+        innerIds.pop_back();
 
-        // Shrink capacity if empty to avoid memory bloat.
-        if (_nodes.size() == _freeNodeIds.size())
+        auto& node = _nodes[nodeId];
+        node = Node{};
+        node.LeftChildId              = leftChildId;
+        node.RightChildId             = rightChildId;
+        _nodes[leftChildId].ParentId  = nodeId;
+        _nodes[rightChildId].ParentId = nodeId;
+        FitNode(nodeId);
+        return nodeId;
+    }
+
+    // Leaf AABB remains valid if it contains object AABB without being significantly larger.
+    bool BoundingVolumeHierarchy::IsLeafAabbValid(const AxisAlignedBoundingBox& leafAabb, const AxisAlignedBoundingBox& aabb, float boundary)
+    {
+        // Test if object AABB is inside node AABB.
+        if (leafAabb.Contains(aabb) != ContainmentType::Contains)
         {
-            *this = {};
+            return false;
         }
+
+        // Test if object AABB is significantly smaller than node AABB.
+        auto  deltaExtents = leafAabb.Extents - aabb.Extents;
+        float threshold    = boundary * 2;
+        return deltaExtents.x < threshold &&
+               deltaExtents.y < threshold &&
+               deltaExtents.z < threshold;
     }
 
     // Performs left or right tree rotation if input node is imbalanced.
@@ -556,7 +2427,9 @@ namespace Silent::Utils
                 nodeA.Aabb   = AxisAlignedBoundingBox::Merge(nodeB.Aabb, nodeG.Aabb);
                 nodeC.Aabb   = AxisAlignedBoundingBox::Merge(nodeA.Aabb, nodeF.Aabb);
                 nodeA.Height = std::max(nodeB.Height, nodeG.Height) + 1;
+                nodeA.Cost   = nodeA.Aabb.GetSurfaceArea() + nodeB.Cost + nodeG.Cost;
                 nodeC.Height = std::max(nodeA.Height, nodeF.Height) + 1;
+                nodeC.Cost   = nodeC.Aabb.GetSurfaceArea() + nodeA.Cost + nodeF.Cost;
 
                 nodeG.ParentId     = nodeId;
                 nodeC.RightChildId = nodeIdF;
@@ -567,7 +2440,9 @@ namespace Silent::Utils
                 nodeA.Aabb   = AxisAlignedBoundingBox::Merge(nodeB.Aabb, nodeF.Aabb);
                 nodeC.Aabb   = AxisAlignedBoundingBox::Merge(nodeA.Aabb, nodeG.Aabb);
                 nodeA.Height = std::max(nodeB.Height, nodeF.Height) + 1;
+                nodeA.Cost   = nodeA.Aabb.GetSurfaceArea() + nodeB.Cost + nodeF.Cost;
                 nodeC.Height = std::max(nodeA.Height, nodeG.Height) + 1;
+                nodeC.Cost   = nodeC.Aabb.GetSurfaceArea() + nodeA.Cost + nodeG.Cost;
 
                 nodeF.ParentId = nodeId;
                 nodeC.RightChildId = nodeIdG;
@@ -618,7 +2493,9 @@ namespace Silent::Utils
                 nodeA.Aabb   = AxisAlignedBoundingBox::Merge(nodeC.Aabb, nodeE.Aabb);
                 nodeB.Aabb   = AxisAlignedBoundingBox::Merge(nodeA.Aabb, nodeD.Aabb);
                 nodeA.Height = std::max(nodeC.Height, nodeE.Height) + 1;
+                nodeA.Cost   = nodeA.Aabb.GetSurfaceArea() + nodeC.Cost + nodeE.Cost;
                 nodeB.Height = std::max(nodeA.Height, nodeD.Height) + 1;
+                nodeB.Cost   = nodeB.Aabb.GetSurfaceArea() + nodeA.Cost + nodeD.Cost;
 
                 nodeB.RightChildId = nodeIdD;
                 nodeA.LeftChildId  = nodeIdE;
@@ -629,7 +2506,9 @@ namespace Silent::Utils
                 nodeA.Aabb  = AxisAlignedBoundingBox::Merge(nodeC.Aabb, nodeD.Aabb);
                 nodeB.Aabb  = AxisAlignedBoundingBox::Merge(nodeA.Aabb, nodeE.Aabb);
                 nodeA.Height = std::max(nodeC.Height, nodeD.Height) + 1;
+                nodeA.Cost   = nodeA.Aabb.GetSurfaceArea() + nodeC.Cost + nodeD.Cost;
                 nodeB.Height = std::max(nodeA.Height, nodeE.Height) + 1;
+                nodeB.Cost   = nodeB.Aabb.GetSurfaceArea() + nodeA.Cost + nodeE.Cost;
 
                 nodeB.RightChildId = nodeIdE;
                 nodeA.LeftChildId  = nodeIdD;
@@ -644,6 +2523,38 @@ namespace Silent::Utils
 
     void BoundingVolumeHierarchy::Build(const std::vector<int>& objectIds, const std::vector<AxisAlignedBoundingBox>& aabbs, BvhBuildStrategy strategy)
     {
+        _isWideDirty = true;
+
+        // Binned strategy: build subtrees in parallel into preallocated nodes.
+        if (strategy == BvhBuildStrategy::Binned)
+        {
+            auto primIds = std::vector<int>(objectIds.size());
+            std::iota(primIds.begin(), primIds.end(), 0);
+
+            _nodes.resize((objectIds.size() * 2) - 1);
+            _rootId = BuildBinned(aabbs, primIds, 0, (int)objectIds.size());
+
+            // Assign objects to leaves.
+            _leafIdMap.reserve(objectIds.size());
+            for (int i = 0; i < primIds.size(); i++)
+            {
+                int   leafId = i * 2;
+                auto& leaf   = _nodes[leafId];
+
+                leaf.ObjectId   = objectIds[primIds[i]];
+                leaf.Generation = _nextGeneration++;
+                _leafIdMap.insert({ leaf.ObjectId, leafId });
+            }
+
+            return;
+        }
+        // Linear strategy: emit hierarchy from Morton-sorted centers in parallel.
+        else if (strategy == BvhBuildStrategy::Linear)
+        {
+            BuildLinear(objectIds, aabbs);
+            return;
+        }
+
         // Reserve enough memory for optimally balanced tree.
         _nodes.reserve((objectIds.size() * 2) - 1);
 
@@ -679,8 +2590,9 @@ namespace Silent::Utils
         {
             int leafId = (int)_nodes.size();
 
-            node.ObjectId = objectIds[start];
-            node.Height   = 0;
+            node.ObjectId   = objectIds[start];
+            node.Height     = 0;
+            node.Generation = _nextGeneration++;
 
             // Add new leaf.
             _nodes.push_back(node);
@@ -757,31 +2669,425 @@ namespace Silent::Utils
             node.Height = std::max((node.LeftChildId != NO_VALUE) ? _nodes[node.LeftChildId].Height : 0, 
                                    (node.RightChildId != NO_VALUE) ? _nodes[node.RightChildId].Height : 0) + 1;
 
+            // Set cost.
+            node.Cost = node.Aabb.GetSurfaceArea() + ((node.LeftChildId != NO_VALUE) ? _nodes[node.LeftChildId].Cost : 0.0f) +
+                        ((node.RightChildId != NO_VALUE) ? _nodes[node.RightChildId].Cost : 0.0f);
+
             // Add new inner node.
             _nodes.push_back(node);
             return nodeId;
         }
     }
 
-    void BoundingVolumeHierarchy::Validate() const
+    // Partitions primitives by lowest cost split of binned surface area heuristic. Returns split offset.
+    int BoundingVolumeHierarchy::GetBinnedSplit(const std::vector<AxisAlignedBoundingBox>& aabbs, std::span<int> primIds)
     {
-        Validate(_rootId);
+        struct Bin
+        {
+            Vector3 Min   = Vector3(INFINITY);
+            Vector3 Max   = Vector3(-INFINITY);
+            uint    Count = 0;
+        };
+
+        // Compute centroid bounds.
+        auto centerMin = Vector3(INFINITY);
+        auto centerMax = Vector3(-INFINITY);
+        for (int primId : primIds)
+        {
+            const auto& center = aabbs[primId].Center;
+            centerMin = Vector3::Min(centerMin, center);
+            centerMax = Vector3::Max(centerMax, center);
+        }
+
+        // Fill bins of all axes in one pass. Small ranges use fewer bins, as they dominate node count.
+        auto centerExtents = centerMax - centerMin;
+        auto binScales     = Vector3::Zero;
+        int  binCount      = std::min((int)SAH_BIN_COUNT, (int)primIds.size());
+        auto bins          = std::array<std::array<Bin, SAH_BIN_COUNT>, Vector3::AXIS_COUNT>{};
+        for (int axis = 0; (uint)axis < Vector3::AXIS_COUNT; axis++)
+        {
+            binScales[axis] = (centerExtents[axis] > EPSILON) ? ((float)binCount / centerExtents[axis]) : 0.0f;
+        }
+        for (int primId : primIds)
+        {
+            const auto& aabb = aabbs[primId];
+            auto        min  = aabb.GetMin();
+            auto        max  = aabb.GetMax();
+            for (int axis = 0; (uint)axis < Vector3::AXIS_COUNT; axis++)
+            {
+                int binIdx = std::min((int)((aabb.Center[axis] - centerMin[axis]) * binScales[axis]), binCount - 1);
+
+                auto& bin = bins[axis][binIdx];
+                bin.Min = Vector3::Min(bin.Min, min);
+                bin.Max = Vector3::Max(bin.Max, max);
+                bin.Count++;
+            }
+        }
+
+        // Find split with lowest surface area heuristic cost.
+        auto getArea = [](const Vector3& min, const Vector3& max)
+        {
+            auto size = max - min;
+            return ((size.x * size.y) + (size.y * size.z) + (size.z * size.x)) * 2.0f;
+        };
 
-        // Validate unique object IDs.
-        auto objectIds = GetBoundedObjectIds();
-        for (int refObjectId : objectIds)
+        int   bestAxis   = NO_VALUE;
+        int   bestBinIdx = NO_VALUE;
+        float bestCost   = INFINITY;
+        for (int axis = 0; (uint)axis < Vector3::AXIS_COUNT; axis++)
         {
-            uint count = 0;
-            for (int objectId : objectIds)
+            // Degenerate axis; all centroids share one bin.
+            if (binScales[axis] == 0.0f)
             {
-                if (refObjectId == objectId)
+                continue;
+            }
+
+            // Sweep right to left to accumulate right side costs.
+            const auto& axisBins   = bins[axis];
+            auto        rightCosts = std::array<float, SAH_BIN_COUNT>{};
+            auto        rightMin   = Vector3(INFINITY);
+            auto        rightMax   = Vector3(-INFINITY);
+            uint        rightCount = 0;
+            for (int i = binCount - 1; i > 0; i--)
+            {
+                rightMin       = Vector3::Min(rightMin, axisBins[i].Min);
+                rightMax       = Vector3::Max(rightMax, axisBins[i].Max);
+                rightCount    += axisBins[i].Count;
+                rightCosts[i]  = (rightCount > 0) ? (getArea(rightMin, rightMax) * rightCount) : 0.0f;
+            }
+
+            // Sweep left to right and evaluate split after each bin.
+            auto leftMin   = Vector3(INFINITY);
+            auto leftMax   = Vector3(-INFINITY);
+            uint leftCount = 0;
+            for (int i = 0; i < (binCount - 1); i++)
+            {
+                leftMin    = Vector3::Min(leftMin, axisBins[i].Min);
+                leftMax    = Vector3::Max(leftMax, axisBins[i].Max);
+                leftCount += axisBins[i].Count;
+                if (leftCount == 0 || leftCount == primIds.size())
+                {
+                    continue;
+                }
+
+                float cost = (getArea(leftMin, leftMax) * leftCount) + rightCosts[i + 1];
+                if (cost < bestCost)
+                {
+                    bestAxis   = axis;
+                    bestBinIdx = i;
+                    bestCost   = cost;
+                }
+            }
+        }
+
+        // Partition primitives. Falls back to median split if centroids coincide.
+        if (bestAxis == NO_VALUE)
+        {
+            return (int)primIds.size() / 2;
+        }
+
+        auto it = std::partition(primIds.begin(), primIds.end(), [&](int primId)
+        {
+            int binIdx = std::min((int)((aabbs[primId].Center[bestAxis] - centerMin[bestAxis]) * binScales[bestAxis]), binCount - 1);
+            return binIdx <= bestBinIdx;
+        });
+        return (int)(it - primIds.begin());
+    }
+
+    // Builds subtree over `primIds[start, end)` and returns its root ID.
+    // Subtree occupies node IDs `[start * 2, (end * 2) - 1)`: left subtree, then root, then right subtree. Leaf of `primIds[i]` is node `i * 2`.
+    // Fixed ID ranges let subtrees be built concurrently without synchronization.
+    int BoundingVolumeHierarchy::BuildBinned(const std::vector<AxisAlignedBoundingBox>& aabbs, std::span<int> primIds, int start, int end)
+    {
+        // Leaf node.
+        if ((end - start) == 1)
+        {
+            int   leafId = start * 2;
+            auto& leaf   = _nodes[leafId];
+
+            leaf.Aabb   = aabbs[primIds[start]];
+            leaf.Height = 0;
+            return leafId;
+        }
+
+        // Partition primitives.
+        int split = start + GetBinnedSplit(aabbs, primIds.subspan(start, end - start));
+
+        // Build children. Large left subtrees are built on worker while calling thread builds right.
+        int leftChildId  = NO_VALUE;
+        int rightChildId = NO_VALUE;
+        if ((end - start) >= PARALLEL_BUILD_SIZE_MIN)
+        {
+            auto buildLeft = [&]()
+            {
+                leftChildId = BuildBinned(aabbs, primIds, start, split);
+            };
+
+            auto group = g_Parallel.CreateGroup();
+            g_Parallel.AddJob(group, [&buildLeft]()
+            {
+                buildLeft();
+            });
+            g_Parallel.CloseGroup(group);
+
+            rightChildId = BuildBinned(aabbs, primIds, split, end);
+            group.Wait();
+        }
+        else
+        {
+            leftChildId  = BuildBinned(aabbs, primIds, start, split);
+            rightChildId = BuildBinned(aabbs, primIds, split, end);
+        }
+
+        // Create inner node between subtrees.
+        int   nodeId = (split * 2) - 1;
+        auto& node   = _nodes[nodeId];
+
+        node.LeftChildId              = leftChildId;
+        node.RightChildId             = rightChildId;
+        _nodes[leftChildId].ParentId  = nodeId;
+        _nodes[rightChildId].ParentId = nodeId;
+        FitNode(nodeId);
+        return nodeId;
+    }
+
+    // Builds linear BVH over Morton-sorted object centers. Leaf of sorted object `i` is node `(count - 1) + i`, inner nodes occupy `[0, count - 1)` with root first.
+    // Reference: Karras, "Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d Trees", 2012.
+    void BoundingVolumeHierarchy::BuildLinear(const std::vector<int>& objectIds, const std::vector<AxisAlignedBoundingBox>& aabbs)
+    {
+        constexpr int GRAIN_SIZE = 1024;
+
+        int count = (int)objectIds.size();
+
+        // Compute centroid bounds.
+        using Bounds = std::pair<Vector3, Vector3>;
+        auto centerBounds = ParallelReduce(0, count, GRAIN_SIZE, Bounds(Vector3(INFINITY), Vector3(-INFINITY)), [&](int i)
+        {
+            return Bounds(aabbs[i].Center, aabbs[i].Center);
+        },
+        [](const Bounds& bounds0, const Bounds& bounds1)
+        {
+            return Bounds(Vector3::Min(bounds0.first, bounds1.first), Vector3::Max(bounds0.second, bounds1.second));
+        });
+
+        // Compute keys. Object index in lower bits keeps keys unique, as hierarchy emission requires.
+        auto centerExtents = centerBounds.second - centerBounds.first;
+        auto centerScale   = Vector3(
+            (centerExtents.x > EPSILON) ? (1.0f / centerExtents.x) : 0.0f,
+            (centerExtents.y > EPSILON) ? (1.0f / centerExtents.y) : 0.0f,
+            (centerExtents.z > EPSILON) ? (1.0f / centerExtents.z) : 0.0f);
+
+        // HEAP ALLOC: Sort keys.
+        auto keys = std::vector<uint64>(count);
+        ParallelFor(0, count, GRAIN_SIZE, [&](int i)
+        {
+            uint code = GetMortonCode((aabbs[i].Center - centerBounds.first) * centerScale);
+            keys[i]   = ((uint64)code << 32) | (uint)i;
+        });
+        SortMortonKeys(keys);
+
+        // Create leaves.
+        int leafIdOffset = count - 1;
+        _nodes.resize((count * 2) - 1);
+        ParallelFor(0, count, GRAIN_SIZE, [&](int i)
+        {
+            int   objectIdx = (int)(keys[i] & 0xFFFFFFFF);
+            auto& leaf      = _nodes[leafIdOffset + i];
+
+            leaf.ObjectId   = objectIds[objectIdx];
+            leaf.Aabb       = aabbs[objectIdx];
+            leaf.Height     = 0;
+            leaf.Generation = _nextGeneration + i;
+        });
+        _nextGeneration += count;
+
+        _leafIdMap.reserve(count);
+        for (int i = 0; i < count; i++)
+        {
+            int leafId = leafIdOffset + i;
+            _leafIdMap.insert({ _nodes[leafId].ObjectId, leafId });
+        }
+
+        // Single leaf.
+        _rootId = 0;
+        if (count == 1)
+        {
+            return;
+        }
+
+        // Emit inner nodes independently. Inner node `i` spans sorted range with one end at `i` and splits it at highest differing key bit.
+        auto getPrefixLength = [&](int i, int j)
+        {
+            if (j < 0 || j >= count)
+            {
+                return NO_VALUE;
+            }
+
+            return std::countl_zero(keys[i] ^ keys[j]);
+        };
+
+        ParallelFor(0, count - 1, GRAIN_SIZE, [&](int i)
+        {
+            // Determine direction of range.
+            int dir = (getPrefixLength(i, i + 1) > getPrefixLength(i, i - 1)) ? 1 : -1;
+
+            // Find other end of range with exponential, then binary search.
+            int prefixLengthMin = getPrefixLength(i, i - dir);
+            int lengthMax       = 2;
+            while (getPrefixLength(i, i + (lengthMax * dir)) > prefixLengthMin)
+            {
+                lengthMax *= 2;
+            }
+
+            int length = 0;
+            for (int step = lengthMax / 2; step > 0; step /= 2)
+            {
+                if (getPrefixLength(i, i + ((length + step) * dir)) > prefixLengthMin)
+                {
+                    length += step;
+                }
+            }
+
+            // Find split with binary search.
+            int j            = i + (length * dir);
+            int prefixLength = getPrefixLength(i, j);
+            int splitOffset  = 0;
+            int step         = length;
+            do
+            {
+                step = (step + 1) / 2;
+                if (getPrefixLength(i, i + ((splitOffset + step) * dir)) > prefixLength)
                 {
-                    count++;
+                    splitOffset += step;
                 }
             }
+            while (step > 1);
+
+            // Link children. Child covering single key is leaf.
+            int   split = i + (splitOffset * dir) + std::min(dir, 0);
+            auto& node  = _nodes[i];
+
+            node.LeftChildId                   = (std::min(i, j) == split)       ? (leafIdOffset + split)       : split;
+            node.RightChildId                  = (std::max(i, j) == (split + 1)) ? (leafIdOffset + split + 1) : (split + 1);
+            _nodes[node.LeftChildId].ParentId  = i;
+            _nodes[node.RightChildId].ParentId = i;
+        });
+
+        // Fit inner nodes bottom-up. Second thread to reach node has both subtrees complete, fits it, and may rotate it.
+        auto visitCounts = std::make_unique<std::atomic<int>[]>(count - 1);
+        ParallelFor(0, count, GRAIN_SIZE, [&](int i)
+        {
+            int nodeId = _nodes[leafIdOffset + i].ParentId;
+            while (nodeId != NO_VALUE && visitCounts[nodeId].fetch_add(1, std::memory_order_acq_rel) == 1)
+            {
+                FitNode(nodeId);
+                RotateNode(nodeId);
+
+                nodeId = _nodes[nodeId].ParentId;
+            }
+        });
+    }
+
+    // Swaps child with grandchild or grandchildren across node's children if it reduces their summed surface area.
+    // Node's own AABB is unchanged, so ancestors stay valid apart from height.
+    // Reference: https://github.com/erincatto/box2d/blob/28adacf82377d4113f2ed00586141463244b9d10/src/dynamic_tree.c
+    void BoundingVolumeHierarchy::RotateNode(int nodeId)
+    {
+        auto& nodeA = _nodes[nodeId];
+        if (nodeA.Height < 2 || nodeA.LeftChildId == NO_VALUE || nodeA.RightChildId == NO_VALUE)
+        {
+            return;
+        }
+
+        int   nodeIdB = nodeA.LeftChildId;
+        int   nodeIdC = nodeA.RightChildId;
+        auto& nodeB   = _nodes[nodeIdB];
+        auto& nodeC   = _nodes[nodeIdC];
+
+        auto getArea = [&](int nodeId0, int nodeId1)
+        {
+            return AxisAlignedBoundingBox::Merge(_nodes[nodeId0].Aabb, _nodes[nodeId1].Aabb).GetSurfaceArea();
+        };
+
+        // Find swap with largest area reduction.
+        int   bestNodeId0 = NO_VALUE;
+        int   bestNodeId1 = NO_VALUE;
+        float bestCost    = 0.0f;
+        auto  trySwap     = [&](int nodeId0, int nodeId1, float cost)
+        {
+            if (cost < bestCost)
+            {
+                bestNodeId0 = nodeId0;
+                bestNodeId1 = nodeId1;
+                bestCost    = cost;
+            }
+        };
+
+        float areaB    = nodeB.Aabb.GetSurfaceArea();
+        float areaC    = nodeC.Aabb.GetSurfaceArea();
+        bool  isInnerB = nodeB.LeftChildId != NO_VALUE && nodeB.RightChildId != NO_VALUE;
+        bool  isInnerC = nodeC.LeftChildId != NO_VALUE && nodeC.RightChildId != NO_VALUE;
+        if (isInnerC)
+        {
+            trySwap(nodeIdB, nodeC.LeftChildId,  getArea(nodeIdB, nodeC.RightChildId) - areaC);
+            trySwap(nodeIdB, nodeC.RightChildId, getArea(nodeIdB, nodeC.LeftChildId)  - areaC);
+        }
+        if (isInnerB)
+        {
+            trySwap(nodeIdC, nodeB.LeftChildId,  getArea(nodeIdC, nodeB.RightChildId) - areaB);
+            trySwap(nodeIdC, nodeB.RightChildId, getArea(nodeIdC, nodeB.LeftChildId)  - areaB);
+        }
+        if (isInnerB && isInnerC)
+        {
+            trySwap(nodeB.LeftChildId, nodeC.LeftChildId,  (getArea(nodeC.LeftChildId,  nodeB.RightChildId) + getArea(nodeB.LeftChildId, nodeC.RightChildId)) - (areaB + areaC));
+            trySwap(nodeB.LeftChildId, nodeC.RightChildId, (getArea(nodeC.RightChildId, nodeB.RightChildId) + getArea(nodeC.LeftChildId, nodeB.LeftChildId))  - (areaB + areaC));
+        }
+
+        if (bestNodeId0 == NO_VALUE)
+        {
+            return;
+        }
+
+        // Swap nodes between parents.
+        auto& node0     = _nodes[bestNodeId0];
+        auto& node1     = _nodes[bestNodeId1];
+        int   parentId0 = node0.ParentId;
+        int   parentId1 = node1.ParentId;
+        auto& parent0   = _nodes[parentId0];
+        auto& parent1   = _nodes[parentId1];
+        ((parent0.LeftChildId == bestNodeId0) ? parent0.LeftChildId : parent0.RightChildId) = bestNodeId1;
+        ((parent1.LeftChildId == bestNodeId1) ? parent1.LeftChildId : parent1.RightChildId) = bestNodeId0;
+        std::swap(node0.ParentId, node1.ParentId);
+
+        // Refit parents bottom-up. Parent of grandchild is child of A, parent of other node is A or other child of A.
+        FitNode(parentId1);
+        if (parentId0 != nodeId)
+        {
+            FitNode(parentId0);
+        }
+        FitNode(nodeId);
+    }
+
+    void BoundingVolumeHierarchy::Validate() const
+    {
+        Validate(_rootId);
+
+        // Validate object-leaf associations. Each leaf being mapped by own object ID and equal counts imply unique object IDs.
+        uint leafCount = 0;
+        for (int i = 0; i < _nodes.size(); i++)
+        {
+            const auto& node = _nodes[i];
+            if (node.ObjectId == NO_VALUE)
+            {
+                continue;
+            }
 
-            Assert(count == 1, "BVH: Duplicate object IDs contained.");
+            auto it = _leafIdMap.find(node.ObjectId);
+            Assert(it != _leafIdMap.end() && it->second == i, "BVH: Leaf missing from object-leaf map or duplicate object IDs contained.");
+            leafCount++;
         }
+
+        Assert(leafCount == _leafIdMap.size(), "BVH: Object-leaf map contains stale leaves.");
     }
 
     void BoundingVolumeHierarchy::Validate(int nodeId) const
@@ -838,6 +3144,12 @@ namespace Silent::Utils
             Assert(node.Height < parent.Height, "BVH: Child height must be less than parent height.");
         }
 
+        // Validate generation.
+        if (node.IsLeaf())
+        {
+            Assert(node.Generation != 0, "BVH: Leaf node must have generation.");
+        }
+
         // Validate recursively.
         Validate(node.LeftChildId);
         Validate(node.RightChildId);
@@ -8,8 +8,8 @@ using namespace Silent::Math;
 // https://github.com/erincatto/box2d/blob/28adacf82377d4113f2ed00586141463244b9d10/src/dynamic_tree.c
 // https://www.gdcvault.com/play/1025909/Math-for-Game-Developers-Dynamic
 
-// NOTE: `_leafIdMap` is a hash map for convenience. If performance suffers with too many `Move` and `Remove` calls, a method with faster access can be implemented.
-// However, it requires maintaining an odd index variable outside the BVH instance, so a hash map is preferred for the benefit of cleaner code.
+// NOTE: `_leafIdMap` is a hash map for convenience when addressing objects by ID. Where many `Move` and `Remove` calls are made,
+// `BvhHandle` returned by `Insert` or `GetHandle` indexes the leaf directly without hashing.
 
 namespace Silent::Utils
 {
@@ -17,7 +17,69 @@ namespace Silent::Utils
     {
         Fast,     // O(n): Fast build, okay quality. Top-down approach with median split.
         Balanced, // O(n * m): Efficient build, good quality. Top-down approach with constrained surface area heuristic.
-        Accurate  // O(n²): Slow build, optimal quality. Top-down approach with exhaustive surface area heuristic.
+        Accurate, // O(n²): Slow build, optimal quality. Top-down approach with exhaustive surface area heuristic.
+        Binned,   // O(n log n): Fast parallel build, good quality. Top-down approach with binned surface area heuristic.
+        Linear    // O(n): Fastest parallel build, okay quality. Bottom-up approach over Morton-sorted centers with local rotations.
+    };
+
+    enum class BvhNodeFormat
+    {
+        Full,     // 128-byte 4-wide nodes with float child bounds. Exact.
+        Quantized // 64-byte 4-wide nodes with 8-bit child bounds relative to node bounds. Half memory, conservative.
+    };
+
+    /** @brief Generational handle of leaf. Leaf IDs are stable while the leaf exists, and generation detects stale handles. */
+    struct BvhHandle
+    {
+        int  LeafId     = NO_VALUE;
+        uint Generation = 0; // 0 if invalid.
+    };
+
+    /** @brief Tree quality metrics. Costs are relative to root surface area, so trees of different scales compare directly. */
+    struct BvhQualityMetrics
+    {
+        float SahCost     = 0.0f; // Summed surface area of inner nodes.
+        float OverlapCost = 0.0f; // Summed surface area of overlap between children of inner nodes.
+        uint  Height      = 0;
+        uint  LeafCount   = 0;
+        uint  InnerCount  = 0;
+    };
+
+    struct BvhRayHit
+    {
+        int   ObjectId = NO_VALUE;
+        float Distance = 0.0f;
+    };
+
+    struct BvhNeighbor
+    {
+        int   ObjectId = NO_VALUE;
+        float Distance = 0.0f; // Distance from query point to object AABB. 0 if inside.
+    };
+
+    struct BvhObjectPair
+    {
+        int ObjectId0 = NO_VALUE;
+        int ObjectId1 = NO_VALUE;
+    };
+
+    /** @brief Overlapping object pairs of broadphase queries. Reused across queries to avoid reallocation. */
+    struct BvhPairResults
+    {
+        std::vector<BvhObjectPair>              Pairs     = {};
+        std::vector<std::pair<int, int>>        NodePairs = {}; // Scratch of node pairs descended by parallel tasks.
+        std::vector<std::vector<BvhObjectPair>> TaskPairs = {}; // Scratch of parallel tasks.
+    };
+
+    /** @brief Flat results of batched queries. Results of query `i` are `ObjectIds[Offsets[i]]` to `ObjectIds[Offsets[i + 1]]`. */
+    struct BvhQueryResults
+    {
+        std::vector<int>              ObjectIds      = {};
+        std::vector<uint>             Offsets        = {}; // Prefix offsets. Size is query count + 1.
+        std::vector<std::vector<int>> ChunkObjectIds = {}; // Scratch of parallel chunks, reused across batches.
+
+        uint                 GetQueryCount() const;
+        std::span<const int> GetObjectIds(uint queryIdx) const;
     };
 
     /** @brief Dynamic bounding volume hierarchy using AABBs. */
@@ -26,23 +88,166 @@ namespace Silent::Utils
     private:
         struct Node
         {
-            int                    ObjectId = NO_VALUE; // NOTE: Only stored by leaf.
-            AxisAlignedBoundingBox Aabb     = AxisAlignedBoundingBox();
+            int                    ObjectId   = NO_VALUE; // NOTE: Only stored by leaf.
+            uint                   Generation = 0;        // NOTE: Only stored by leaf.
+            AxisAlignedBoundingBox Aabb       = AxisAlignedBoundingBox();
 
             int Height       = 0;
-            int ParentId     = NO_VALUE;
+            int ParentId     = NO_VALUE; // NOTE: Next free node ID if node is free.
             int LeftChildId  = NO_VALUE;
             int RightChildId = NO_VALUE;
 
+            float Cost          = 0.0f; // Surface area heuristic cost of subtree: summed surface area of inner nodes.
+            float BaseCostRatio = 0.0f; // Cost relative to own surface area, recorded at first batched refit after build. Unset if 0.
+
             bool IsLeaf() const;
         };
 
+        // Constants
+
+        static constexpr uint  WIDE_NODE_CHILD_COUNT   = 4;
+        static constexpr uint  WIDE_STACK_SIZE         = 256;
+        static constexpr uint  RAY_PACKET_SIZE_MAX     = 16;
+        static constexpr uint  BATCH_CHUNK_SIZE        = 64;
+        static constexpr uint  SAH_BIN_COUNT           = 32;
+        static constexpr uint  PARALLEL_BUILD_SIZE_MIN = 1024;
+        static constexpr uint  PAIR_TASK_COUNT         = 64;
+        static constexpr uint  OPTIMIZE_SCAN_COUNT     = 256;
+        static constexpr uint  REBUILD_HEIGHT_MIN      = 3;
+        static constexpr float REFIT_COST_RATIO_MAX    = 1.5f;
+
+        /** @brief Collapsed node of compiled query form. Child bounds are stored as SoA to be tested in one SIMD pass.
+         * Empty lanes have inverted bounds, so they never pass overlap tests. */
+        struct alignas(64) WideNode
+        {
+            using Lanes = std::array<float, WIDE_NODE_CHILD_COUNT>;
+
+            Lanes MinX = {};
+            Lanes MinY = {};
+            Lanes MinZ = {};
+            Lanes MaxX = {};
+            Lanes MaxY = {};
+            Lanes MaxZ = {};
+
+            std::array<int, WIDE_NODE_CHILD_COUNT> ChildIds  = {}; // Wide node ID of inner child, otherwise `NO_VALUE`.
+            std::array<int, WIDE_NODE_CHILD_COUNT> ObjectIds = {}; // Object ID of leaf child, otherwise `NO_VALUE`.
+        };
+
+        /** @brief Compressed node of quantized compiled form. Child bounds are 8-bit offsets from node origin in power-of-2 steps per axis,
+         * rounded outward so queries never miss a hit. Decoded to `WideNode` lanes on access.
+         * Reference: Ylitie et al., "Efficient Incoherent Ray Traversal on GPUs Through Compressed Wide BVHs", 2017. */
+        struct alignas(64) QuantizedNode
+        {
+            using Lanes = std::array<uint8, WIDE_NODE_CHILD_COUNT>;
+
+            std::array<float, 3> Origin    = {}; // Min corner of node bounds.
+            std::array<int8, 3>  Exponents = {}; // Quantization step of each axis is `2^Exponents[axis]`.
+            uint8                ChildMask = 0;  // Bit per lane with child.
+            uint8                LeafMask  = 0;  // Bit per lane with leaf child.
+
+            Lanes MinX = {};
+            Lanes MinY = {};
+            Lanes MinZ = {};
+            Lanes MaxX = {};
+            Lanes MaxY = {};
+            Lanes MaxZ = {};
+
+            std::array<int, WIDE_NODE_CHILD_COUNT> ChildIds = {}; // Object ID of leaf child, otherwise quantized node ID of inner child.
+        };
+
+        /** @brief Nodes traversed by queries: compiled nodes of either format, or binary nodes while compiled form is stale.
+         * Binary nodes are viewed as wide nodes with up to 2 lanes, so queries share one traversal. */
+        struct QueryNodes
+        {
+            std::span<const WideNode>      WideNodes      = {};
+            std::span<const QuantizedNode> QuantizedNodes = {};
+            std::span<const Node>          BinaryNodes    = {};
+            int                            RootId         = 0; // Compiled root is first.
+
+            uint GetCount() const; // Compiled node count.
+            bool IsEmpty() const;
+
+            /** @brief Gets node, decoding quantized or binary node into `decodedNode`. */
+            const WideNode& GetNode(int nodeId, WideNode& decodedNode) const;
+        };
+
+        /** @brief Fixed traversal stack of `WIDE_STACK_SIZE` entries. Entries past capacity spill to heap, so trees too deep for
+         * fixed stack, such as unbalanced trees from surface area heuristic builds and rotations, are traversed correctly rather than overrunning it. */
+        template <typename TEntry>
+        class TraversalStack
+        {
+        private:
+            std::array<TEntry, WIDE_STACK_SIZE> _entries      = {};
+            std::vector<TEntry>                 _spillEntries = {};
+            uint                                _size         = 0;
+
+        public:
+            bool IsEmpty() const
+            {
+                return _size == 0;
+            }
+
+            void Push(const TEntry& entry)
+            {
+                if (_size < WIDE_STACK_SIZE)
+                {
+                    _entries[_size++] = entry;
+                    return;
+                }
+
+                // HEAP ALLOC: Spill only once fixed stack is full. Spilled entries are newest, so they are popped first.
+                if constexpr (IS_DEBUG_BUILD)
+                {
+                    Log("BVH: Traversal stack overflow. Tree is too deep for fixed stack.", LogLevel::Warning, LogMode::Debug);
+                }
+                _spillEntries.push_back(entry);
+            }
+
+            TEntry Pop()
+            {
+                if (!_spillEntries.empty())
+                {
+                    auto entry = _spillEntries.back();
+                    _spillEntries.pop_back();
+                    return entry;
+                }
+
+                return _entries[--_size];
+            }
+        };
+
+        /** @brief Header of serialized tree. Compiled nodes follow directly and link by index, so blob is position-independent. */
+        struct alignas(64) BlobHeader
+        {
+            uint32 Magic       = 0;
+            uint32 Version     = 0;
+            uint32 NodeFormat  = 0; // `BvhNodeFormat`.
+            uint32 NodeSize    = 0; // Detects layout changes not covered by version.
+            uint32 NodeCount   = 0;
+            uint32 ObjectCount = 0;
+        };
+
+        static constexpr uint32 BLOB_MAGIC   = 0x48564253; // "SBVH" in little endian.
+        static constexpr uint32 BLOB_VERSION = 2;
+
         // Fields
 
-        std::vector<Node>            _nodes       = {};
-        std::stack<int>              _freeNodeIds = {};
-        std::unordered_map<int, int> _leafIdMap   = {}; // Key = object ID, value = leaf ID.
-        int                          _rootId      = NO_VALUE;
+        std::vector<Node>            _nodes          = {};
+        int                          _freeNodeId     = NO_VALUE; // Head of intrusive free list.
+        uint                         _freeNodeCount  = 0;
+        uint                         _nextGeneration = 1;
+        std::unordered_map<int, int> _leafIdMap      = {}; // Key = object ID, value = leaf ID.
+        int                          _rootId         = NO_VALUE;
+
+        uint _optimizeCursor = 0; // Node ID last scanned by incremental optimizer.
+
+        mutable std::vector<WideNode>      _wideNodes      = {};   // Compiled query form. Root is first.
+        mutable std::vector<QuantizedNode> _quantizedNodes = {};   // Compiled query form if quantized. Root is first.
+        mutable bool                       _isWideDirty    = true; // Tree modified since last compile.
+        BvhNodeFormat                      _nodeFormat     = BvhNodeFormat::Full;
+
+        QueryNodes    _mappedNodes       = {}; // Compiled query form of serialized tree viewed in place. Tree is read-only if set.
+        uint          _mappedObjectCount = 0;
 
     public:
         // Constructors
@@ -50,46 +255,537 @@ namespace Silent::Utils
         BoundingVolumeHierarchy() = default;
         BoundingVolumeHierarchy(const std::vector<int>& objectIds, const std::vector<AxisAlignedBoundingBox>& aabbs, BvhBuildStrategy strategy = BvhBuildStrategy::Balanced);
 
+        /** @brief Views serialized tree in place without parsing or copying. Blob must be 64-byte aligned, as memory-mapped files are,
+         * and outlive tree unchanged. Tree is read-only and supports compiled queries only: no broadphase pairs, handles, or modification. */
+        BoundingVolumeHierarchy(std::span<const std::byte> blob);
+
         // Getters
 
-        uint GetSize() const;
+        uint              GetSize() const;
+        BvhNodeFormat     GetNodeFormat() const;
+        uint64            GetCompiledByteSize() const;
+        BvhHandle         GetHandle(int objectId) const;
+        BvhQualityMetrics GetQualityMetrics() const;
 
         std::vector<int> GetBoundedObjectIds() const;
         std::vector<int> GetBoundedObjectIds(const Ray& ray, float dist) const;
         std::vector<int> GetBoundedObjectIds(const BoundingSphere& sphere) const;
         std::vector<int> GetBoundedObjectIds(const AxisAlignedBoundingBox& aabb) const;
         std::vector<int> GetBoundedObjectIds(const OrientedBoundingBox& obb) const;
+        std::vector<int> GetBoundedObjectIds(const Frustum& frustum) const;
+
+        // Allocation-free getters
+
+        /** @brief Writes IDs of bounded objects to `objectIds` until full. Returns written count. */
+        uint GetBoundedObjectIds(std::span<int> objectIds, const Ray& ray, float dist) const;
+        uint GetBoundedObjectIds(std::span<int> objectIds, const BoundingSphere& sphere) const;
+        uint GetBoundedObjectIds(std::span<int> objectIds, const AxisAlignedBoundingBox& aabb) const;
+        uint GetBoundedObjectIds(std::span<int> objectIds, const OrientedBoundingBox& obb) const;
+        uint GetBoundedObjectIds(std::span<int> objectIds, const Frustum& frustum) const;
+
+        /** @brief Invokes `visitor(objectId)` for each bounded object. Visitor returning `bool` stops traversal by returning `false`.
+         * Returns `false` if stopped early. Allocation-free on compiled and binary forms unless tree is too deep for fixed traversal stack. */
+        template <typename TVisitor>
+        bool Query(const Ray& ray, float dist, TVisitor&& visitor) const
+        {
+            auto invDir    = Vector3::One / ray.Direction;
+            auto nearDists = WideNode::Lanes{};
+            return TraverseWide([&](const WideNode& wideNode)
+            {
+                return TestWideNode(wideNode, ray.Origin, invDir, dist, nearDists);
+            }, visitor);
+        }
+
+        template <typename TVisitor>
+        bool Query(const BoundingSphere& sphere, TVisitor&& visitor) const
+        {
+            return TraverseWide([&](const WideNode& wideNode)
+            {
+                return TestWideNode(wideNode, sphere);
+            }, visitor);
+        }
+
+        template <typename TVisitor>
+        bool Query(const AxisAlignedBoundingBox& aabb, TVisitor&& visitor) const
+        {
+            return TraverseWide([&](const WideNode& wideNode)
+            {
+                return TestWideNode(wideNode, aabb);
+            }, visitor);
+        }
+
+        template <typename TVisitor>
+        bool Query(const OrientedBoundingBox& obb, TVisitor&& visitor) const
+        {
+            return TraverseWide([&](const WideNode& wideNode)
+            {
+                return TestWideNode(wideNode, obb);
+            }, visitor);
+        }
+
+        /** @brief Frustum query with plane masking. Planes a node lies fully inside are skipped for its subtree,
+         * so subtrees fully inside frustum are collected without further plane tests. */
+        template <typename TVisitor>
+        bool Query(const Frustum& frustum, TVisitor&& visitor) const
+        {
+            auto queryNodes = GetQueryNodes();
+            if (queryNodes.IsEmpty())
+            {
+                return true;
+            }
+
+            // Traverse compiled tree with mask of planes each node straddles.
+            auto decodedNode    = WideNode{};
+            auto stack          = TraversalStack<std::pair<int, uint>>{}; // First = wide node ID, second = plane mask.
+            auto lanePlaneMasks = std::array<uint, WIDE_NODE_CHILD_COUNT>{};
+            stack.Push({ queryNodes.RootId, (1 << Frustum::PLANE_COUNT) - 1 });
+            while (!stack.IsEmpty())
+            {
+                auto [wideNodeId, planeMask] = stack.Pop();
+                const auto& wideNode = queryNodes.GetNode(wideNodeId, decodedNode);
+
+                // Test child lanes against remaining planes and visit overlapping ones.
+                uint laneMask = TestWideNode(wideNode, frustum, planeMask, lanePlaneMasks);
+                while (laneMask != 0)
+                {
+                    int laneIdx = std::countr_zero(laneMask);
+                    laneMask   &= laneMask - 1;
+
+                    // Leaf child; visit object ID.
+                    if (wideNode.ObjectIds[laneIdx] != NO_VALUE)
+                    {
+                        if (!Visit(visitor, wideNode.ObjectIds[laneIdx]))
+                        {
+                            return false;
+                        }
+                    }
+                    // Inner child; push onto stack with planes it straddles.
+                    else
+                    {
+                        stack.Push({ wideNode.ChildIds[laneIdx], lanePlaneMasks[laneIdx] });
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // Setters
+
+        /** @brief Sets format of compiled query form, applied on next `Compile`. Queries of quantized form test slightly enlarged bounds,
+         * so overlap queries may return extra objects and nearest neighbor distances may be up to one quantization step shorter. */
+        void SetNodeFormat(BvhNodeFormat format);
 
         // Inquirers
 
         bool IsEmpty() const;
+        bool IsValid(const BvhHandle& handle) const;
+
+        static bool IsBlobValid(std::span<const std::byte> blob);
 
         // Utilities
 
-        void Insert(int objectId, const AxisAlignedBoundingBox& aabb, float boundary = 0.0f);
-        void Move(int objectId, const AxisAlignedBoundingBox& aabb, float boundary = 0.0f);
-        void Remove(int objectId);
+        BvhHandle Insert(int objectId, const AxisAlignedBoundingBox& aabb, float boundary = 0.0f);
+        void      Move(int objectId, const AxisAlignedBoundingBox& aabb, float boundary = 0.0f);
+        void      Move(const BvhHandle& handle, const AxisAlignedBoundingBox& aabb, float boundary = 0.0f);
+        void      Remove(int objectId);
+        void      Remove(const BvhHandle& handle);
+
+        /** @brief Moves objects in bulk. Leaf bounds are updated in place and ancestors refit bottom-up once, without reinsertion.
+         * Subtrees whose cost relative to their surface area grows past `REFIT_COST_RATIO_MAX` times its first refit value are rebuilt. */
+        void Move(std::span<const int> objectIds, std::span<const AxisAlignedBoundingBox> aabbs, float boundary = 0.0f);
+        void Move(std::span<const BvhHandle> handles, std::span<const AxisAlignedBoundingBox> aabbs, float boundary = 0.0f);
+
+        /** @brief Incrementally improves tree quality within time budget. Scans nodes in windows from where previous call stopped and
+         * reinserts subtrees of least efficient inner node in each window. Intended to be called once per tick for long-lived dynamic trees. */
+        void Optimize(uint64 budgetMicrosec);
+
+        /** @brief Serializes compiled query form to versioned, position-independent blob for `BoundingVolumeHierarchy(blob)`.
+         * Layout is native endian, so blobs must be cooked for target platform. */
+        std::vector<std::byte> Serialize() const;
+
+        /** @brief Rebuilds compiled 4-wide query form if tree was modified. Queries never compile: while compiled form is stale,
+         * they traverse binary tree, so modifications interleaved with queries stay O(log n). Call once modifications of a tick are done. */
+        void Compile() const;
+
+        // Batched getters
+
+        /** @brief Traces rays in packets of up to 16 sharing one traversal. Results of ray `i` are objects whose bounds it hits within `dist`.
+         * Packets are distributed across workers. */
+        void GetBoundedObjectIds(BvhQueryResults& results, std::span<const Ray> rays, float dist) const;
+
+        /** @brief Runs overlap queries in parallel across workers. Results of query `i` are objects it bounds. */
+        void GetBoundedObjectIds(BvhQueryResults& results, std::span<const BoundingSphere> spheres) const;
+        void GetBoundedObjectIds(BvhQueryResults& results, std::span<const AxisAlignedBoundingBox> aabbs) const;
+
+        // Broadphase
+
+        /** @brief Gets each pair of objects with overlapping AABBs once, ordered by object ID within pair.
+         * Descends tree against itself simultaneously, with subtree pairs distributed across workers. */
+        void GetOverlappingPairs(BvhPairResults& results) const;
+
+        /** @brief Gets pairs of overlapping objects between this and another tree. First object of pair is from this tree. */
+        void GetOverlappingPairs(BvhPairResults& results, const BoundingVolumeHierarchy& bvh) const;
+
+        // Ray casts
+
+        /** @brief Finds closest object hit by ray within `dist`. `intersectRoutine(objectId)` returns exact hit distance as `std::optional<float>`.
+         * Children are visited front to back and pruned by closest confirmed hit, so few exact tests run. */
+        template <typename TFunc>
+        std::optional<BvhRayHit> GetClosestHit(const Ray& ray, float dist, const TFunc& intersectRoutine) const
+        {
+            auto queryNodes = GetQueryNodes();
+            if (queryNodes.IsEmpty())
+            {
+                return std::nullopt;
+            }
+
+            auto invDir    = Vector3::One / ray.Direction;
+            auto nearDists = WideNode::Lanes{};
+            auto closest   = BvhRayHit{ NO_VALUE, dist };
+
+            // Traverse compiled tree with entry distances to skip nodes behind closest hit.
+            auto decodedNode = WideNode{};
+            auto stack       = TraversalStack<std::pair<int, float>>{}; // First = wide node ID, second = entry distance.
+            stack.Push({ queryNodes.RootId, -INFINITY });
+            while (!stack.IsEmpty())
+            {
+                auto [wideNodeId, nearDist] = stack.Pop();
+                if (nearDist > closest.Distance)
+                {
+                    continue;
+                }
+
+                const auto& wideNode = queryNodes.GetNode(wideNodeId, decodedNode);
+
+                // Sort overlapping lanes front to back.
+                uint laneMask  = TestWideNode(wideNode, ray.Origin, invDir, closest.Distance, nearDists);
+                auto laneIdxs  = std::array<int, WIDE_NODE_CHILD_COUNT>{};
+                uint laneCount = 0;
+                while (laneMask != 0)
+                {
+                    int laneIdx = std::countr_zero(laneMask);
+                    laneMask   &= laneMask - 1;
+
+                    int i = laneCount++;
+                    for (; i > 0 && nearDists[laneIdxs[i - 1]] > nearDists[laneIdx]; i--)
+                    {
+                        laneIdxs[i] = laneIdxs[i - 1];
+                    }
+                    laneIdxs[i] = laneIdx;
+                }
+
+                // Test leaves front to back, shrinking closest distance.
+                for (int i = 0; (uint)i < laneCount; i++)
+                {
+                    int laneIdx  = laneIdxs[i];
+                    int objectId = wideNode.ObjectIds[laneIdx];
+                    if (objectId == NO_VALUE || nearDists[laneIdx] > closest.Distance)
+                    {
+                        continue;
+                    }
+
+                    auto hitDist = intersectRoutine(objectId);
+                    if (hitDist.has_value() && *hitDist <= closest.Distance)
+                    {
+                        closest = BvhRayHit{ objectId, *hitDist };
+                    }
+                }
+
+                // Push inner children back to front, so nearest is popped first.
+                for (int i = (int)laneCount - 1; i >= 0; i--)
+                {
+                    int laneIdx = laneIdxs[i];
+                    if (wideNode.ObjectIds[laneIdx] != NO_VALUE || nearDists[laneIdx] > closest.Distance)
+                    {
+                        continue;
+                    }
+
+                    stack.Push({ wideNode.ChildIds[laneIdx], nearDists[laneIdx] });
+                }
+            }
+
+            if (closest.ObjectId == NO_VALUE)
+            {
+                return std::nullopt;
+            }
+
+            return closest;
+        }
+
+        /** @brief Gets all objects hit by ray within `dist`, sorted by distance. `intersectRoutine(objectId)` returns exact hit distance as `std::optional<float>`. */
+        template <typename TFunc>
+        std::vector<BvhRayHit> GetSortedHits(const Ray& ray, float dist, const TFunc& intersectRoutine) const
+        {
+            auto hits = std::vector<BvhRayHit>{};
+            Query(ray, dist, [&](int objectId)
+            {
+                auto hitDist = intersectRoutine(objectId);
+                if (hitDist.has_value() && *hitDist <= dist)
+                {
+                    hits.push_back(BvhRayHit{ objectId, *hitDist });
+                }
+            });
+
+            // Sort by distance. Ties are ordered by object ID to stay deterministic.
+            std::sort(hits.begin(), hits.end(), [](const BvhRayHit& hit0, const BvhRayHit& hit1)
+            {
+                return (hit0.Distance != hit1.Distance) ? (hit0.Distance < hit1.Distance) : (hit0.ObjectId < hit1.ObjectId);
+            });
+            return hits;
+        }
+
+        // Nearest neighbors
+
+        std::optional<BvhNeighbor> GetNearestNeighbor(const Vector3& point, float maxDist = INFINITY) const;
+        std::vector<BvhNeighbor>   GetNearestNeighbors(const Vector3& point, uint count, float maxDist = INFINITY) const;
+
+        /** @brief Finds closest object to `point` within `maxDist` accepted by `filterRoutine(objectId)`, which returns `bool`. */
+        template <typename TFilter>
+        std::optional<BvhNeighbor> GetNearestNeighbor(const Vector3& point, float maxDist, const TFilter& filterRoutine) const
+        {
+            auto neighbor = BvhNeighbor{};
+            if (GetNearestNeighbors(std::span<BvhNeighbor>(&neighbor, 1), point, maxDist, filterRoutine) == 0)
+            {
+                return std::nullopt;
+            }
+
+            return neighbor;
+        }
+
+        /** @brief Writes up to `neighbors.size()` objects closest to `point` within `maxDist` and accepted by `filterRoutine(objectId)`,
+         * sorted by distance. Returns written count. Allocation-free like `Query`.
+         * Kept neighbors form bounded max heap in `neighbors`. Children are visited nearest first and pruned by distance of farthest kept neighbor once full. */
+        template <typename TFilter>
+        uint GetNearestNeighbors(std::span<BvhNeighbor> neighbors, const Vector3& point, float maxDist, const TFilter& filterRoutine) const
+        {
+            auto queryNodes = GetQueryNodes();
+            if (queryNodes.IsEmpty() || neighbors.empty())
+            {
+                return 0;
+            }
+
+            // Order by distance. Ties are ordered by object ID to stay deterministic.
+            auto compare = [](const BvhNeighbor& neighbor0, const BvhNeighbor& neighbor1)
+            {
+                return (neighbor0.Distance != neighbor1.Distance) ? (neighbor0.Distance < neighbor1.Distance) : (neighbor0.ObjectId < neighbor1.ObjectId);
+            };
+
+            // Distances are squared until results are written.
+            auto  distsSqr   = WideNode::Lanes{};
+            float distSqrMax = SQUARE(maxDist);
+            uint  count      = 0;
+
+            // Traverse compiled tree with entry distances to skip nodes beyond farthest kept neighbor.
+            auto decodedNode = WideNode{};
+            auto stack       = TraversalStack<std::pair<int, float>>{}; // First = wide node ID, second = squared entry distance.
+            stack.Push({ queryNodes.RootId, 0.0f });
+            while (!stack.IsEmpty())
+            {
+                auto [wideNodeId, distSqr] = stack.Pop();
+                if (distSqr > distSqrMax)
+                {
+                    continue;
+                }
+
+                const auto& wideNode = queryNodes.GetNode(wideNodeId, decodedNode);
+
+                // Sort lanes within distance near to far.
+                uint laneMask  = TestWideNode(wideNode, point, distSqrMax, distsSqr);
+                auto laneIdxs  = std::array<int, WIDE_NODE_CHILD_COUNT>{};
+                uint laneCount = 0;
+                while (laneMask != 0)
+                {
+                    int laneIdx = std::countr_zero(laneMask);
+                    laneMask   &= laneMask - 1;
+
+                    int i = laneCount++;
+                    for (; i > 0 && distsSqr[laneIdxs[i - 1]] > distsSqr[laneIdx]; i--)
+                    {
+                        laneIdxs[i] = laneIdxs[i - 1];
+                    }
+                    laneIdxs[i] = laneIdx;
+                }
+
+                // Keep leaves near to far, shrinking distance once full.
+                for (int i = 0; (uint)i < laneCount; i++)
+                {
+                    int laneIdx  = laneIdxs[i];
+                    int objectId = wideNode.ObjectIds[laneIdx];
+                    if (objectId == NO_VALUE || distsSqr[laneIdx] > distSqrMax || !filterRoutine(objectId))
+                    {
+                        continue;
+                    }
+
+                    auto neighbor = BvhNeighbor{ objectId, distsSqr[laneIdx] };
+                    if (count < neighbors.size())
+                    {
+                        neighbors[count++] = neighbor;
+                        std::push_heap(neighbors.begin(), neighbors.begin() + count, compare);
+                    }
+                    else if (compare(neighbor, neighbors[0]))
+                    {
+                        std::pop_heap(neighbors.begin(), neighbors.begin() + count, compare);
+                        neighbors[count - 1] = neighbor;
+                        std::push_heap(neighbors.begin(), neighbors.begin() + count, compare);
+                    }
+
+                    if (count == neighbors.size())
+                    {
+                        distSqrMax = std::min(distSqrMax, neighbors[0].Distance);
+                    }
+                }
+
+                // Push inner children far to near, so nearest is popped first.
+                for (int i = (int)laneCount - 1; i >= 0; i--)
+                {
+                    int laneIdx = laneIdxs[i];
+                    if (wideNode.ObjectIds[laneIdx] != NO_VALUE || distsSqr[laneIdx] > distSqrMax)
+                    {
+                        continue;
+                    }
+
+                    stack.Push({ wideNode.ChildIds[laneIdx], distsSqr[laneIdx] });
+                }
+            }
+
+            // Sort kept neighbors and resolve distances.
+            std::sort_heap(neighbors.begin(), neighbors.begin() + count, compare);
+            for (auto& neighbor : neighbors.first(count))
+            {
+                neighbor.Distance = std::sqrt(neighbor.Distance);
+            }
+
+            return count;
+        }
 
     private:
         // Collision helpers
 
-        std::vector<int> GetBoundedObjectIds(const std::function<bool(const Node& node)>& testCollRoutine) const;
+        /** @brief Traverses compiled form. `testWideRoutine(wideNode)` returns bit mask of overlapping child lanes.
+         * Returns `false` if visitor stopped traversal early. */
+        template <typename TTestFunc, typename TVisitor>
+        bool TraverseWide(const TTestFunc& testWideRoutine, TVisitor& visitor) const
+        {
+            auto queryNodes = GetQueryNodes();
+            if (queryNodes.IsEmpty())
+            {
+                return true;
+            }
+
+            // Traverse compiled tree.
+            auto decodedNode = WideNode{};
+            auto stack       = TraversalStack<int>{}; // Wide node IDs.
+            stack.Push(queryNodes.RootId);
+            while (!stack.IsEmpty())
+            {
+                const auto& wideNode = queryNodes.GetNode(stack.Pop(), decodedNode);
+
+                // Test child lanes and visit overlapping ones.
+                uint laneMask = testWideRoutine(wideNode);
+                while (laneMask != 0)
+                {
+                    int laneIdx = std::countr_zero(laneMask);
+                    laneMask   &= laneMask - 1;
+
+                    // Leaf child; visit object ID.
+                    if (wideNode.ObjectIds[laneIdx] != NO_VALUE)
+                    {
+                        if (!Visit(visitor, wideNode.ObjectIds[laneIdx]))
+                        {
+                            return false;
+                        }
+                    }
+                    // Inner child; push onto stack for traversal.
+                    else
+                    {
+                        stack.Push(wideNode.ChildIds[laneIdx]);
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /** @brief Invokes visitor. Returns `false` if visitor returns `bool` and requested stop. */
+        template <typename TVisitor>
+        static bool Visit(TVisitor& visitor, int objectId)
+        {
+            if constexpr (std::is_convertible_v<std::invoke_result_t<TVisitor&, int>, bool>)
+            {
+                return visitor(objectId);
+            }
+            else
+            {
+                visitor(objectId);
+                return true;
+            }
+        }
+
+        static uint TestWideNode(const WideNode& wideNode, const Vector3& rayOrigin, const Vector3& rayInvDir, float dist, WideNode::Lanes& nearDists);
+        static uint TestWideNode(const WideNode& wideNode, const AxisAlignedBoundingBox& aabb);
+        static uint TestWideNode(const WideNode& wideNode, const BoundingSphere& sphere);
+        static uint TestWideNode(const WideNode& wideNode, const OrientedBoundingBox& obb);
+
+        /** @brief Writes squared distances from `point` to child lanes to `distsSqr`. Returns mask of lanes within `distSqrMax`. */
+        static uint TestWideNode(const WideNode& wideNode, const Vector3& point, float distSqrMax, WideNode::Lanes& distsSqr);
+
+        /** @brief Tests child lanes against planes in `planeMask`. Writes mask of planes each overlapping lane straddles to `lanePlaneMasks`. */
+        static uint TestWideNode(const WideNode& wideNode, const Frustum& frustum, uint planeMask, std::array<uint, WIDE_NODE_CHILD_COUNT>& lanePlaneMasks);
+
+        // Batch helpers
+
+        void GetBatchResults(BvhQueryResults& results, uint queryCount, const std::function<void(uint start, uint end, std::vector<int>& objectIds, std::span<uint> counts)>& queryChunk) const;
+        void TraceRayPacket(std::span<const Ray> rays, float dist, std::vector<int>& objectIds, std::span<uint> counts) const;
+
+        // Broadphase helpers
+
+        void GetPairs(BvhPairResults& results, const BoundingVolumeHierarchy& bvh) const;
+        void ExpandNodePair(const BoundingVolumeHierarchy& bvh, const std::pair<int, int>& nodePair,
+                            std::vector<std::pair<int, int>>& nodePairs, std::vector<BvhObjectPair>& pairs) const;
+
+        // Compile helpers
+
+        int           CompileNode(int nodeId) const;
+        QueryNodes    GetQueryNodes() const;
+
+        static QuantizedNode QuantizeNode(const WideNode& wideNode);
+        static void          DecodeNode(const QuantizedNode& quantizedNode, WideNode& wideNode);
 
         // Dynamic helpers
 
-        int GetNewNodeId();
-        int GetBestSiblingLeafId(int leafId) const;
+        int   GetNewNodeId();
+        int   GetBestSiblingLeafId(int leafId) const;
+        int   GetLeafId(const BvhHandle& handle) const;
+        float GetNodeInefficiency(int nodeId) const;
+        int   GetBestSiblingId(int nodeId) const;
+
+        void MoveLeaf(int leafId, const AxisAlignedBoundingBox& aabb, float boundary);
+        void MarkRefitLeaf(int leafId, const AxisAlignedBoundingBox& aabb, float boundary);
+        void RefitMarkedNodes();
+        void ReinsertNode(int nodeId);
+        void InsertNode(int nodeId);
 
         void InsertLeaf(int leafId);
         void RemoveLeaf(int leafId);
         void RefitNode(int nodeId);
+        void FitNode(int nodeId);
         void RemoveNode(int nodeId);
         int  BalanceNode(int nodeId);
+        int  RebuildNode(int nodeId);
+        int  BuildSubtree(const std::vector<AxisAlignedBoundingBox>& aabbs, std::span<int> primIds, std::span<const int> leafIds, std::vector<int>& innerIds);
+
+        static bool IsLeafAabbValid(const AxisAlignedBoundingBox& leafAabb, const AxisAlignedBoundingBox& aabb, float boundary);
 
         // Static helpers
 
         void Build(const std::vector<int>& objectIds, const std::vector<AxisAlignedBoundingBox>& aabbs, BvhBuildStrategy strategy);
         int  Build(const std::vector<int>& objectIds, const std::vector<AxisAlignedBoundingBox>& aabbs, int start, int end, BvhBuildStrategy strategy);
+        int  BuildBinned(const std::vector<AxisAlignedBoundingBox>& aabbs, std::span<int> primIds, int start, int end);
+        void BuildLinear(const std::vector<int>& objectIds, const std::vector<AxisAlignedBoundingBox>& aabbs);
+        void RotateNode(int nodeId);
+
+        static int GetBinnedSplit(const std::vector<AxisAlignedBoundingBox>& aabbs, std::span<int> primIds);
 
         // Debug helpers
 
@@ -86,6 +86,7 @@ namespace Silent::Utils::Debug
             constexpr const char* CONTROL_INVERSION_ITEMS[] = { "Normal", "Reverse" };
             constexpr const char* WEAPON_CONTROL_ITEMS[]    = { "Switch", "Press" };
             constexpr const char* VIEW_MODE_ITEMS[]         = { "Normal", "Self view" };
+            constexpr const char* PARALLEL_LANE_ITEMS[]     = { "Critical lane:", "Normal lane:", "Background lane:" };
 
             auto& options  = g_App.GetOptions();
             auto& renderer = g_App.GetRenderer();
@@ -263,8 +264,9 @@ namespace Silent::Utils::Debug
                 // `Options` tab.
                 if (ImGui::BeginTabItem("Options"))
                 {
-                    g_DebugData.Page  = DebugPage::Options;
-                    bool isOptChanged = false;
+                    g_DebugData.Page       = DebugPage::Options;
+                    bool isOptChanged      = false;
+                    bool isParallelChanged = false;
 
                     // `Graphics` section.
                     ImGui::SeparatorText("Graphics");
@@ -495,6 +497,48 @@ namespace Silent::Utils::Debug
                         {
                             isOptChanged = true;
                         }
+
+                        // `Parallel workers` slider. 0 = automatic. Applied on release, since workers restart.
+                        ImGui::SliderInt("Parallel workers", &options->ParallelWorkerCount, 0, PARALLEL_WORKER_MAX);
+                        if (ImGui::IsItemDeactivatedAfterEdit())
+                        {
+                            isParallelChanged = true;
+                        }
+
+                        // `Reserved core mask` input.
+                        ImGui::InputScalar("Reserved core mask", ImGuiDataType_U64, &options->ParallelReservedCoreMask, nullptr, nullptr, "%llX",
+                                           ImGuiInputTextFlags_CharsHexadecimal);
+                        if (ImGui::IsItemDeactivatedAfterEdit())
+                        {
+                            isParallelChanged = true;
+                        }
+
+                        // `Enable parallel affinity` checkbox.
+                        if (ImGui::Checkbox("Enable parallel affinity", &options->EnableParallelAffinity))
+                        {
+                            isParallelChanged = true;
+                        }
+
+                        // `Benchmark parallelism` button.
+                        if (ImGui::Button("Benchmark parallelism"))
+                        {
+                            BenchmarkParallelism({ 1, 4, 16, 64 }, 100000, 256);
+                        }
+
+                        // `Benchmark worker counts` button. Applies fastest worker count.
+                        ImGui::SameLine();
+                        if (ImGui::Button("Benchmark worker counts"))
+                        {
+                            options->ParallelWorkerCount = (int)BenchmarkParallelWorkerCounts(100000, 256);
+                            isParallelChanged            = true;
+                        }
+                    }
+
+                    // Request worker restart with new topology.
+                    if (isParallelChanged)
+                    {
+                        g_DebugData.IsParallelRestartPending = true;
+                        isOptChanged                         = true;
                     }
 
                     // Save options if changed.
@@ -505,6 +549,118 @@ namespace Silent::Utils::Debug
 
                     ImGui::EndTabItem();
                 }
+                // `Parallel` tab.
+                if (ImGui::BeginTabItem("Parallel"))
+                {
+                    g_DebugData.Page = DebugPage::Parallel;
+
+                    // `Lanes` section.
+                    ImGui::SeparatorText("Lanes");
+                    {
+                        if (ImGui::BeginTable("Lanes", 2))
+                        {
+                            for (int i = 0; i < (int)ParallelPriority::Count; i++)
+                            {
+                                auto stats = g_Parallel.GetLaneStats((ParallelPriority)i);
+                                ImGui::TableNextRow();
+                                ImGui::TableSetColumnIndex(0);
+                                ImGui::TextUnformatted(PARALLEL_LANE_ITEMS[i]);
+                                ImGui::TableSetColumnIndex(1);
+                                ImGui::TextUnformatted((std::to_string(stats.MissedGroupCount) + " missed / " + std::to_string(stats.CompletedGroupCount) + " groups").c_str());
+                            }
+
+                            ImGui::EndTable();
+                        }
+                    }
+
+                    if constexpr (IS_PARALLEL_STATS_BUILD)
+                    {
+                        // Add table row of thread stats.
+                        auto addThreadStatsRow = [](const std::string& label, const ParallelThreadStats& stats)
+                        {
+                            uint64 busyNanosec  = stats.BusyNanosec.load(std::memory_order_relaxed);
+                            uint64 idleNanosec  = stats.IdleNanosec.load(std::memory_order_relaxed);
+                            uint64 stealNanosec = stats.StealNanosec.load(std::memory_order_relaxed);
+                            float  totalNanosec = std::max((float)(busyNanosec + idleNanosec + stealNanosec), 1.0f);
+
+                            ImGui::TableNextRow();
+                            ImGui::TableSetColumnIndex(0);
+                            ImGui::TextUnformatted(label.c_str());
+                            ImGui::TableSetColumnIndex(1);
+                            ImGui::TextUnformatted(std::to_string(stats.ExecutedJobCount.load(std::memory_order_relaxed)).c_str());
+                            ImGui::TableSetColumnIndex(2);
+                            ImGui::TextUnformatted(std::to_string(stats.StealCount.load(std::memory_order_relaxed)).c_str());
+                            ImGui::TableSetColumnIndex(3);
+                            ImGui::Text("%.1f%%", ((float)busyNanosec / totalNanosec) * 100.0f);
+                            ImGui::TableSetColumnIndex(4);
+                            ImGui::Text("%.1f%%", ((float)idleNanosec / totalNanosec) * 100.0f);
+                            ImGui::TableSetColumnIndex(5);
+                            ImGui::Text("%.1f%%", ((float)stealNanosec / totalNanosec) * 100.0f);
+                        };
+
+                        // `Workers` section.
+                        ImGui::SeparatorText("Workers");
+                        {
+                            if (ImGui::BeginTable("Workers", 6))
+                            {
+                                ImGui::TableSetupColumn("Thread");
+                                ImGui::TableSetupColumn("Jobs");
+                                ImGui::TableSetupColumn("Steals");
+                                ImGui::TableSetupColumn("Busy");
+                                ImGui::TableSetupColumn("Idle");
+                                ImGui::TableSetupColumn("Stealing");
+                                ImGui::TableHeadersRow();
+
+                                for (int i = 0; (uint)i < g_Parallel.GetThreadCount(); i++)
+                                {
+                                    addThreadStatsRow("Worker " + std::to_string(i), g_Parallel.GetWorkerStats(i));
+                                }
+                                addThreadStatsRow("Helpers", g_Parallel.GetHelperStats());
+
+                                ImGui::EndTable();
+                            }
+                        }
+
+                        // `Queue depth` section.
+                        ImGui::SeparatorText("Queue Depth");
+                        {
+                            auto samples = g_Parallel.GetQueueDepthSamples();
+                            ImGui::PlotLines("##QueueDepth", samples.data(), (int)samples.size(), (int)g_Parallel.GetQueueDepthSampleOffset(), nullptr, 0.0f, FLT_MAX,
+                                             ImVec2(0.0f, 60.0f));
+                        }
+
+                        // `Histograms` section. Merged across threads, log2 nanosecond buckets.
+                        ImGui::SeparatorText("Histograms");
+                        {
+                            auto latencyHistogram   = std::array<float, PARALLEL_HISTOGRAM_BUCKET_COUNT>{};
+                            auto executionHistogram = std::array<float, PARALLEL_HISTOGRAM_BUCKET_COUNT>{};
+                            auto addHistograms      = [&](const ParallelThreadStats& stats)
+                            {
+                                for (int i = 0; (uint)i < PARALLEL_HISTOGRAM_BUCKET_COUNT; i++)
+                                {
+                                    latencyHistogram[i]   += (float)stats.LatencyHistogram[i].load(std::memory_order_relaxed);
+                                    executionHistogram[i] += (float)stats.ExecutionHistogram[i].load(std::memory_order_relaxed);
+                                }
+                            };
+
+                            for (int i = 0; (uint)i < g_Parallel.GetThreadCount(); i++)
+                            {
+                                addHistograms(g_Parallel.GetWorkerStats(i));
+                            }
+                            addHistograms(g_Parallel.GetHelperStats());
+
+                            ImGui::PlotHistogram("Enqueue to start", latencyHistogram.data(), (int)latencyHistogram.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+                            ImGui::PlotHistogram("Execution", executionHistogram.data(), (int)executionHistogram.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+                        }
+                    }
+                    else
+                    {
+                        ImGui::Text("Parallel stats compiled out. Define `PARALLEL_STATS` to enable in release builds.");
+                    }
+
+                    ImGui::EndTabItem();
+                }
+
                 ImGui::EndTabBar();
             }
 
@@ -28,7 +28,8 @@ namespace Silent::Utils::Debug
         Renderer,
         Input,
         Cheats,
-        Options
+        Options,
+        Parallel
     };
 
     struct DebugData
@@ -39,6 +40,10 @@ namespace Silent::Utils::Debug
 
         bool EnableWireframeMode = false;
         float BlendAlpha = 0.0f;
+
+        // Parallel
+
+        bool IsParallelRestartPending = false; // Applied between ticks, since tick pipeline runs on workers.
     };
 
     extern DebugData g_DebugData;
@@ -0,0 +1,388 @@
+#include "Framework.h"
+#include "Utils/MeshBvh.h"
+
+#include "Math/Math.h"
+#include "Utils/BoundingVolumeHierarchy.h"
+
+namespace Silent::Utils
+{
+    // Reference: Moller and Trumbore, "Fast, Minimum Storage Ray/Triangle Intersection", 1997.
+    static std::optional<float> IntersectTriangle(const Ray& ray, const std::array<Vector3, 3>& vertices)
+    {
+        auto  edge0 = vertices[1] - vertices[0];
+        auto  edge1 = vertices[2] - vertices[0];
+        auto  pVec  = Vector3::Cross(ray.Direction, edge1);
+        float det   = Vector3::Dot(edge0, pVec);
+
+        // Ray parallel to triangle plane.
+        if (det == 0.0f)
+        {
+            return std::nullopt;
+        }
+
+        // Test barycentric coordinates. Both faces are hit.
+        float invDet = 1.0f / det;
+        auto  tVec   = ray.Origin - vertices[0];
+        float u      = Vector3::Dot(tVec, pVec) * invDet;
+        if (u < 0.0f || u > 1.0f)
+        {
+            return std::nullopt;
+        }
+
+        auto  qVec = Vector3::Cross(tVec, edge0);
+        float v    = Vector3::Dot(ray.Direction, qVec) * invDet;
+        if (v < 0.0f || (u + v) > 1.0f)
+        {
+            return std::nullopt;
+        }
+
+        float dist = Vector3::Dot(edge1, qVec) * invDet;
+        if (dist < 0.0f)
+        {
+            return std::nullopt;
+        }
+
+        return dist;
+    }
+
+    // Separating axis test over box face normals, triangle normal, and cross products of box axes and triangle edges.
+    // Reference: Akenine-Moller, "Fast 3D Triangle-Box Overlap Testing", 2001.
+    static bool IntersectsTriangle(const AxisAlignedBoundingBox& aabb, const std::array<Vector3, 3>& vertices)
+    {
+        // Translate triangle so box is centered at origin.
+        auto vert0 = vertices[0] - aabb.Center;
+        auto vert1 = vertices[1] - aabb.Center;
+        auto vert2 = vertices[2] - aabb.Center;
+
+        // Separated if triangle projection lies outside box projection. Degenerate zero axes never separate.
+        auto isSeparated = [&](const Vector3& axis)
+        {
+            float proj0  = Vector3::Dot(vert0, axis);
+            float proj1  = Vector3::Dot(vert1, axis);
+            float proj2  = Vector3::Dot(vert2, axis);
+            float radius = (aabb.Extents.x * std::abs(axis.x)) + (aabb.Extents.y * std::abs(axis.y)) + (aabb.Extents.z * std::abs(axis.z));
+            return std::max({ proj0, proj1, proj2 }) < -radius || std::min({ proj0, proj1, proj2 }) > radius;
+        };
+
+        auto edges    = std::array<Vector3, 3>{ vert1 - vert0, vert2 - vert1, vert0 - vert2 };
+        auto boxAxes  = std::array<Vector3, 3>{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ };
+        for (const auto& boxAxis : boxAxes)
+        {
+            if (isSeparated(boxAxis))
+            {
+                return false;
+            }
+        }
+
+        if (isSeparated(Vector3::Cross(edges[0], edges[1])))
+        {
+            return false;
+        }
+
+        for (const auto& edge : edges)
+        {
+            for (const auto& boxAxis : boxAxes)
+            {
+                if (isSeparated(Vector3::Cross(boxAxis, edge)))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Reference: Ericson, "Real-Time Collision Detection", 2004, section 5.1.5.
+    static Vector3 GetClosestPointOnTriangle(const Vector3& point, const std::array<Vector3, 3>& vertices)
+    {
+        const auto& vert0 = vertices[0];
+        const auto& vert1 = vertices[1];
+        const auto& vert2 = vertices[2];
+
+        // Vertex region of `vert0`.
+        auto  edge0  = vert1 - vert0;
+        auto  edge1  = vert2 - vert0;
+        auto  delta0 = point - vert0;
+        float dot0   = Vector3::Dot(edge0, delta0);
+        float dot1   = Vector3::Dot(edge1, delta0);
+        if (dot0 <= 0.0f && dot1 <= 0.0f)
+        {
+            return vert0;
+        }
+
+        // Vertex region of `vert1`.
+        auto  delta1 = point - vert1;
+        float dot2   = Vector3::Dot(edge0, delta1);
+        float dot3   = Vector3::Dot(edge1, delta1);
+        if (dot2 >= 0.0f && dot3 <= dot2)
+        {
+            return vert1;
+        }
+
+        // Edge region of `vert0` to `vert1`.
+        float area2 = (dot0 * dot3) - (dot2 * dot1);
+        if (area2 <= 0.0f && dot0 >= 0.0f && dot2 <= 0.0f)
+        {
+            return vert0 + (edge0 * (dot0 / (dot0 - dot2)));
+        }
+
+        // Vertex region of `vert2`.
+        auto  delta2 = point - vert2;
+        float dot4   = Vector3::Dot(edge0, delta2);
+        float dot5   = Vector3::Dot(edge1, delta2);
+        if (dot5 >= 0.0f && dot4 <= dot5)
+        {
+            return vert2;
+        }
+
+        // Edge region of `vert0` to `vert2`.
+        float area1 = (dot4 * dot1) - (dot0 * dot5);
+        if (area1 <= 0.0f && dot1 >= 0.0f && dot5 <= 0.0f)
+        {
+            return vert0 + (edge1 * (dot1 / (dot1 - dot5)));
+        }
+
+        // Edge region of `vert1` to `vert2`.
+        float area0 = (dot2 * dot5) - (dot4 * dot3);
+        if (area0 <= 0.0f && (dot3 - dot2) >= 0.0f && (dot4 - dot5) >= 0.0f)
+        {
+            float alpha = (dot3 - dot2) / ((dot3 - dot2) + (dot4 - dot5));
+            return vert1 + ((vert2 - vert1) * alpha);
+        }
+
+        // Face region.
+        float invArea = 1.0f / (area0 + area1 + area2);
+        return vert0 + (edge0 * (area1 * invArea)) + (edge1 * (area2 * invArea));
+    }
+
+    static bool IntersectsTriangle(const BoundingSphere& sphere, const std::array<Vector3, 3>& vertices)
+    {
+        return Vector3::DistanceSquared(GetClosestPointOnTriangle(sphere.Center, vertices), sphere.Center) <= SQUARE(sphere.Radius);
+    }
+
+    MeshBvh::MeshBvh(std::span<const Vector3> vertices, std::span<const TriangleVertexIdxs> triangles, BvhNodeFormat format) :
+        _vertices(vertices.begin(), vertices.end()),
+        _triangles(triangles.begin(), triangles.end())
+    {
+        if (_triangles.empty())
+        {
+            return;
+        }
+
+        // Collect triangle bounds.
+        auto triangleIds = std::vector<int>(_triangles.size());
+        auto aabbs       = std::vector<AxisAlignedBoundingBox>(_triangles.size());
+        for (int i = 0; (uint)i < _triangles.size(); i++)
+        {
+            for (uint vertexIdx : _triangles[i])
+            {
+                Assert(vertexIdx < _vertices.size(), "MeshBvh: Triangle vertex index out of range.");
+            }
+
+            auto vertices = GetTriangle(i);
+            triangleIds[i] = i;
+            aabbs[i]       = AxisAlignedBoundingBox(vertices);
+        }
+
+        // Build and compile once, so queries are thread-safe.
+        _bvh = BoundingVolumeHierarchy(triangleIds, aabbs, BvhBuildStrategy::Binned);
+        _bvh.SetNodeFormat(format);
+        _bvh.Compile();
+
+        _aabb = aabbs.front();
+        for (const auto& aabb : aabbs)
+        {
+            _aabb.Merge(aabb);
+        }
+    }
+
+    uint MeshBvh::GetTriangleCount() const
+    {
+        return (uint)_triangles.size();
+    }
+
+    const AxisAlignedBoundingBox& MeshBvh::GetAabb() const
+    {
+        return _aabb;
+    }
+
+    std::array<Vector3, 3> MeshBvh::GetTriangle(int triangleId) const
+    {
+        const auto& triangle = _triangles[triangleId];
+        return std::array<Vector3, 3>{ _vertices[triangle[0]], _vertices[triangle[1]], _vertices[triangle[2]] };
+    }
+
+    std::optional<MeshTriangleHit> MeshBvh::GetClosestHit(const Ray& ray, float dist) const
+    {
+        auto hit = _bvh.GetClosestHit(ray, dist, [&](int triangleId)
+        {
+            return IntersectTriangle(ray, GetTriangle(triangleId));
+        });
+        if (!hit.has_value())
+        {
+            return std::nullopt;
+        }
+
+        return MeshTriangleHit{ NO_VALUE, hit->ObjectId, hit->Distance };
+    }
+
+    std::vector<int> MeshBvh::GetOverlappingTriangleIds(const AxisAlignedBoundingBox& aabb) const
+    {
+        auto triangleIds = std::vector<int>{};
+        Query(aabb, [&](int triangleId)
+        {
+            if (IntersectsTriangle(aabb, GetTriangle(triangleId)))
+            {
+                triangleIds.push_back(triangleId);
+            }
+        });
+
+        return triangleIds;
+    }
+
+    std::vector<int> MeshBvh::GetOverlappingTriangleIds(const BoundingSphere& sphere) const
+    {
+        auto triangleIds = std::vector<int>{};
+        Query(sphere.ToAabb(), [&](int triangleId)
+        {
+            if (IntersectsTriangle(sphere, GetTriangle(triangleId)))
+            {
+                triangleIds.push_back(triangleId);
+            }
+        });
+
+        return triangleIds;
+    }
+
+    bool MeshBvh::IsEmpty() const
+    {
+        return _triangles.empty();
+    }
+
+    uint MeshInstanceBvh::GetSize() const
+    {
+        return (uint)_instances.size();
+    }
+
+    std::optional<MeshTriangleHit> MeshInstanceBvh::GetClosestHit(const Ray& ray, float dist) const
+    {
+        float closestDist = dist;
+        int   triangleId  = NO_VALUE;
+        auto  hit         = _bvh.GetClosestHit(ray, dist, [&](int instanceId) -> std::optional<float>
+        {
+            // Affine transform keeps ray parameter, so local hit distance is world hit distance. Direction is left unnormalized for this.
+            const auto& instance = _instances.at(instanceId);
+            auto        localRay = Ray(Vector3::Transform(ray.Origin, instance.InverseTransform), Vector3::Rotate(ray.Direction, instance.InverseTransform));
+            auto        localHit = instance.Mesh->GetClosestHit(localRay, closestDist);
+            if (!localHit.has_value())
+            {
+                return std::nullopt;
+            }
+
+            // Hits are within closest distance, so each is accepted by top level.
+            closestDist = localHit->Distance;
+            triangleId  = localHit->TriangleId;
+            return localHit->Distance;
+        });
+        if (!hit.has_value())
+        {
+            return std::nullopt;
+        }
+
+        return MeshTriangleHit{ hit->ObjectId, triangleId, hit->Distance };
+    }
+
+    std::vector<MeshTriangleHit> MeshInstanceBvh::GetOverlappingTriangles(const AxisAlignedBoundingBox& aabb) const
+    {
+        return GetOverlappingTriangles(aabb, [&](const std::array<Vector3, 3>& vertices)
+        {
+            return IntersectsTriangle(aabb, vertices);
+        });
+    }
+
+    std::vector<MeshTriangleHit> MeshInstanceBvh::GetOverlappingTriangles(const BoundingSphere& sphere) const
+    {
+        return GetOverlappingTriangles(sphere.ToAabb(), [&](const std::array<Vector3, 3>& vertices)
+        {
+            return IntersectsTriangle(sphere, vertices);
+        });
+    }
+
+    bool MeshInstanceBvh::IsEmpty() const
+    {
+        return _instances.empty();
+    }
+
+    void MeshInstanceBvh::Insert(int instanceId, const std::shared_ptr<const MeshBvh>& mesh, const Matrix& transform, float boundary)
+    {
+        // FAILSAFE: Find existing instance.
+        if (_instances.contains(instanceId))
+        {
+            Log("MeshInstanceBvh: Attempted to insert instance with existing ID " + std::to_string(instanceId) + ".",
+                LogLevel::Warning, LogMode::Debug, true);
+            return;
+        }
+
+        auto instance = Instance
+        {
+            .Mesh             = mesh,
+            .Transform        = transform,
+            .InverseTransform = Matrix::Inverse(transform)
+        };
+        instance.Handle = _bvh.Insert(instanceId, GetTransformedAabb(mesh->GetAabb(), transform), boundary);
+        _instances.emplace(instanceId, std::move(instance));
+    }
+
+    void MeshInstanceBvh::Move(int instanceId, const Matrix& transform, float boundary)
+    {
+        // FAILSAFE: Find instance.
+        auto it = _instances.find(instanceId);
+        if (it == _instances.end())
+        {
+            Log("MeshInstanceBvh: Attempted to move missing instance with ID " + std::to_string(instanceId) + ".",
+                LogLevel::Warning, LogMode::Debug, true);
+            return;
+        }
+
+        // Update transform and top-level bounds only. Mesh stays in its own space.
+        auto& instance = it->second;
+        instance.Transform        = transform;
+        instance.InverseTransform = Matrix::Inverse(transform);
+        _bvh.Move(instance.Handle, GetTransformedAabb(instance.Mesh->GetAabb(), transform), boundary);
+    }
+
+    void MeshInstanceBvh::Remove(int instanceId)
+    {
+        // FAILSAFE: Find instance.
+        auto it = _instances.find(instanceId);
+        if (it == _instances.end())
+        {
+            Log("MeshInstanceBvh: Attempted to remove missing instance with ID " + std::to_string(instanceId) + ".",
+                LogLevel::Warning, LogMode::Debug, true);
+            return;
+        }
+
+        _bvh.Remove(it->second.Handle);
+        _instances.erase(it);
+    }
+
+    void MeshInstanceBvh::Compile() const
+    {
+        _bvh.Compile();
+    }
+
+    AxisAlignedBoundingBox MeshInstanceBvh::GetTransformedAabb(const AxisAlignedBoundingBox& aabb, const Matrix& transformMat)
+    {
+        // Extents of transformed box are summed absolute projections of transformed axes.
+        // Reference: Arvo, "Transforming Axis-Aligned Bounding Boxes", Graphics Gems, 1990.
+        auto extents = Vector3::Zero;
+        for (int i = 0; (uint)i < Vector3::AXIS_COUNT; i++)
+        {
+            auto axis = Vector3(transformMat[i].x, transformMat[i].y, transformMat[i].z);
+            extents  += Vector3(std::abs(axis.x), std::abs(axis.y), std::abs(axis.z)) * aabb.Extents[i];
+        }
+
+        return AxisAlignedBoundingBox(Vector3::Transform(aabb.Center, transformMat), extents);
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Math/Math.h"
+#include "Utils/BoundingVolumeHierarchy.h"
+
+namespace Silent::Utils
+{
+    struct MeshTriangleHit
+    {
+        int   InstanceId = NO_VALUE; // Instance of two-level queries, otherwise `NO_VALUE`.
+        int   TriangleId = NO_VALUE;
+        float Distance   = 0.0f;     // Ray hit distance. 0 for overlaps.
+    };
+
+    /** @brief Bottom-level BVH over triangles of one mesh. Built once per asset and shared by instances.
+     * Triangles are leaves of quantized compiled tree by default, since exact triangle tests follow every candidate. */
+    class MeshBvh
+    {
+    public:
+        // Aliases
+
+        using TriangleVertexIdxs = std::array<uint, 3>;
+
+    private:
+        // Fields
+
+        std::vector<Vector3>            _vertices  = {};
+        std::vector<TriangleVertexIdxs> _triangles = {};
+        BoundingVolumeHierarchy         _bvh       = {}; // Object ID = triangle ID.
+        AxisAlignedBoundingBox          _aabb      = AxisAlignedBoundingBox(Vector3::Zero, Vector3::Zero);
+
+    public:
+        // Constructors
+
+        MeshBvh() = default;
+        MeshBvh(std::span<const Vector3> vertices, std::span<const TriangleVertexIdxs> triangles, BvhNodeFormat format = BvhNodeFormat::Quantized);
+
+        // Getters
+
+        uint                          GetTriangleCount() const;
+        const AxisAlignedBoundingBox& GetAabb() const;
+        std::array<Vector3, 3>        GetTriangle(int triangleId) const;
+
+        /** @brief Finds closest triangle hit by ray within `dist`. Distance is in units of ray direction length,
+         * so rays transformed into mesh space by affine transform keep their world distances. */
+        std::optional<MeshTriangleHit> GetClosestHit(const Ray& ray, float dist) const;
+
+        std::vector<int> GetOverlappingTriangleIds(const AxisAlignedBoundingBox& aabb) const;
+        std::vector<int> GetOverlappingTriangleIds(const BoundingSphere& sphere) const;
+
+        /** @brief Invokes `visitor(triangleId)` for each triangle whose bounds overlap `aabb`. Candidates are not tested exactly. */
+        template <typename TVisitor>
+        bool Query(const AxisAlignedBoundingBox& aabb, TVisitor&& visitor) const
+        {
+            return _bvh.Query(aabb, visitor);
+        }
+
+        // Inquirers
+
+        bool IsEmpty() const;
+    };
+
+    /** @brief Two-level BVH. Top-level tree over world bounds of mesh instances, each referencing shared bottom-level `MeshBvh`.
+     * Queries are transformed into instance space, so instanced meshes are stored once and instances move without rebuilding meshes. */
+    class MeshInstanceBvh
+    {
+    private:
+        struct Instance
+        {
+            std::shared_ptr<const MeshBvh> Mesh             = nullptr;
+            Matrix                         Transform        = Matrix::Identity; // Mesh to world space.
+            Matrix                         InverseTransform = Matrix::Identity; // World to mesh space.
+            BvhHandle                      Handle           = {};
+        };
+
+        // Fields
+
+        BoundingVolumeHierarchy           _bvh       = {}; // Object ID = instance ID.
+        std::unordered_map<int, Instance> _instances = {}; // Key = instance ID.
+
+    public:
+        // Constructors
+
+        MeshInstanceBvh() = default;
+
+        // Getters
+
+        uint GetSize() const;
+
+        /** @brief Finds closest triangle of any instance hit by ray within `dist`. Instances are visited front to back by world bounds. */
+        std::optional<MeshTriangleHit> GetClosestHit(const Ray& ray, float dist) const;
+
+        std::vector<MeshTriangleHit> GetOverlappingTriangles(const AxisAlignedBoundingBox& aabb) const;
+        std::vector<MeshTriangleHit> GetOverlappingTriangles(const BoundingSphere& sphere) const;
+
+        // Inquirers
+
+        bool IsEmpty() const;
+
+        // Utilities
+
+        void Insert(int instanceId, const std::shared_ptr<const MeshBvh>& mesh, const Matrix& transform, float boundary = 0.0f);
+        void Move(int instanceId, const Matrix& transform, float boundary = 0.0f);
+        void Remove(int instanceId);
+
+        /** @brief Compiles top-level tree. Queries traverse binary top-level tree after modification until called. */
+        void Compile() const;
+
+    private:
+        // Helpers
+
+        /** @brief Gets world triangles overlapping world bounds `aabb`, testing each candidate with `isOverlapRoutine(vertices)`. */
+        template <typename TFunc>
+        std::vector<MeshTriangleHit> GetOverlappingTriangles(const AxisAlignedBoundingBox& aabb, const TFunc& isOverlapRoutine) const
+        {
+            auto hits = std::vector<MeshTriangleHit>{};
+            _bvh.Query(aabb, [&](int instanceId)
+            {
+                const auto& instance  = _instances.at(instanceId);
+                auto        localAabb = GetTransformedAabb(aabb, instance.InverseTransform);
+
+                // Test candidate triangles in world space.
+                instance.Mesh->Query(localAabb, [&](int triangleId)
+                {
+                    auto vertices = instance.Mesh->GetTriangle(triangleId);
+                    for (auto& vertex : vertices)
+                    {
+                        vertex = Vector3::Transform(vertex, instance.Transform);
+                    }
+
+                    if (isOverlapRoutine(vertices))
+                    {
+                        hits.push_back(MeshTriangleHit{ instanceId, triangleId, 0.0f });
+                    }
+                });
+            });
+
+            return hits;
+        }
+
+        static AxisAlignedBoundingBox GetTransformedAabb(const AxisAlignedBoundingBox& aabb, const Matrix& transformMat);
+    };
+}
@@ -3,39 +3,488 @@
 
 #include "Engine/Application.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace Silent::Utils
 {
     ParallelTaskManager g_Parallel = ParallelTaskManager();
 
+    // Worker identity of calling thread. Allows nested submissions to target the worker's own deque.
+    static thread_local const ParallelTaskManager* CurrentManager   = nullptr;
+    static thread_local int                        CurrentWorkerIdx = NO_VALUE;
+
+    static uint64 GetSteadyMicrosec()
+    {
+        return (uint64)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64 GetStatsNanosec()
+    {
+        if constexpr (IS_PARALLEL_STATS_BUILD)
+        {
+            return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        return 0;
+    }
+
+    static void AddStat(std::atomic<uint64>& stat, uint64 value)
+    {
+        if constexpr (IS_PARALLEL_STATS_BUILD)
+        {
+            stat.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    static void AddHistogramSample(ParallelThreadStats::Histogram& histogram, uint64 nanosec)
+    {
+        if constexpr (IS_PARALLEL_STATS_BUILD)
+        {
+            uint bucketIdx = std::min((uint)std::bit_width(nanosec), PARALLEL_HISTOGRAM_BUCKET_COUNT - 1);
+            histogram[bucketIdx].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static json ToStatsJson(const ParallelThreadStats& stats)
+    {
+        auto latencyJson   = json::array();
+        auto executionJson = json::array();
+        for (int i = 0; (uint)i < PARALLEL_HISTOGRAM_BUCKET_COUNT; i++)
+        {
+            latencyJson.push_back(stats.LatencyHistogram[i].load(std::memory_order_relaxed));
+            executionJson.push_back(stats.ExecutionHistogram[i].load(std::memory_order_relaxed));
+        }
+
+        return json
+        {
+            { "ExecutedJobCount",   stats.ExecutedJobCount.load(std::memory_order_relaxed) },
+            { "StealCount",         stats.StealCount.load(std::memory_order_relaxed) },
+            { "BusyNanosec",        stats.BusyNanosec.load(std::memory_order_relaxed) },
+            { "IdleNanosec",        stats.IdleNanosec.load(std::memory_order_relaxed) },
+            { "StealNanosec",       stats.StealNanosec.load(std::memory_order_relaxed) },
+            { "LatencyHistogram",   latencyJson },
+            { "ExecutionHistogram", executionJson }
+        };
+    }
+
+    static void SetThreadAffinity(std::jthread& thread, uint coreId)
+    {
+#if defined(__linux__)
+        auto cpuSet = cpu_set_t{};
+        CPU_ZERO(&cpuSet);
+        CPU_SET(coreId, &cpuSet);
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0)
+        {
+            Log("Failed to pin parallel worker to core " + std::to_string(coreId) + ".", LogLevel::Warning);
+        }
+#else
+        Log("Parallel worker affinity is unsupported on this platform.", LogLevel::Warning, LogMode::Debug);
+#endif
+    }
+
+    // Nesting depth of job execution on calling thread. Busy time is counted at outermost level only.
+    static thread_local uint ExecuteDepth = 0;
+
+    // Steal victim RNG state of non-worker threads helping while waiting.
+    static thread_local uint64 HelperRngState = (uint64)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+    ParallelGroup* ParallelHandle::GetGroup() const
+    {
+        return _group;
+    }
+
+    uint ParallelHandle::GetGeneration() const
+    {
+        return _generation;
+    }
+
+    bool ParallelHandle::IsComplete() const
+    {
+        return _group == nullptr || _group->Generation.load(std::memory_order_acquire) != _generation;
+    }
+
+    void ParallelHandle::Wait() const
+    {
+        if (IsComplete())
+        {
+            return;
+        }
+
+        _group->Manager->Wait(*this);
+    }
+
+    void ParallelFreeList::Initialize(uint capacity)
+    {
+        // Link all IDs in order.
+        _nextIds = std::make_unique<std::atomic<uint>[]>(capacity);
+        for (int i = 0; (uint)i < capacity; i++)
+        {
+            _nextIds[i].store(((uint)i + 1 < capacity) ? (uint)(i + 2) : 0, std::memory_order_relaxed);
+        }
+
+        _head.store((capacity > 0) ? 1 : 0, std::memory_order_release);
+    }
+
+    int ParallelFreeList::Pop()
+    {
+        uint64 head = _head.load(std::memory_order_acquire);
+        while (true)
+        {
+            // Empty.
+            uint idPlusOne = (uint)head;
+            if (idPlusOne == 0)
+            {
+                return NO_VALUE;
+            }
+
+            // Unlink head. Tag increment invalidates stale heads read by concurrent pops.
+            uint   nextIdPlusOne = _nextIds[idPlusOne - 1].load(std::memory_order_relaxed);
+            uint64 newHead       = (((head >> 32) + 1) << 32) | nextIdPlusOne;
+            if (_head.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return (int)(idPlusOne - 1);
+            }
+        }
+    }
+
+    void ParallelFreeList::Push(uint id)
+    {
+        uint64 head    = _head.load(std::memory_order_relaxed);
+        uint64 newHead = 0;
+        do
+        {
+            _nextIds[id].store((uint)head, std::memory_order_relaxed);
+            newHead = (((head >> 32) + 1) << 32) | (id + 1);
+        }
+        while (!_head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    uint ParallelJobDeque::GetSize() const
+    {
+        int64 bottom = _bottom.load(std::memory_order_relaxed);
+        int64 top    = _top.load(std::memory_order_relaxed);
+        return (uint)std::max<int64>(bottom - top, 0);
+    }
+
+    bool ParallelJobDeque::Push(ParallelJob* job)
+    {
+        int64 bottom = _bottom.load(std::memory_order_relaxed);
+        int64 top    = _top.load(std::memory_order_acquire);
+
+        // Full; caller must find another queue.
+        if ((bottom - top) >= (int64)CAPACITY)
+        {
+            return false;
+        }
+
+        // Publish job to thieves.
+        _jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    ParallelJob* ParallelJobDeque::Pop()
+    {
+        // Reserve bottom job.
+        int64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = _top.load(std::memory_order_relaxed);
+
+        // Empty; restore bottom.
+        if (top > bottom)
+        {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto* job = _jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+        // Last job; race thieves for it.
+        if (top == bottom)
+        {
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return job;
+    }
+
+    ParallelJob* ParallelJobDeque::Steal()
+    {
+        int64 top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 bottom = _bottom.load(std::memory_order_acquire);
+
+        // Empty.
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        // Claim top job. Losing the race to owner or another thief aborts steal.
+        auto* job = _jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
+        return job;
+    }
+
+    ParallelJobQueue::ParallelJobQueue()
+    {
+        for (int i = 0; (uint)i < CAPACITY; i++)
+        {
+            _cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool ParallelJobQueue::Push(ParallelJob* job)
+    {
+        uint64 pos = _pushPos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto&  cell = _cells[pos & (CAPACITY - 1)];
+            uint64 seq  = cell.Sequence.load(std::memory_order_acquire);
+            auto   diff = (int64)seq - (int64)pos;
+
+            // Cell free; claim it.
+            if (diff == 0)
+            {
+                if (_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.Job = job;
+                    cell.Sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            // Full.
+            else if (diff < 0)
+            {
+                return false;
+            }
+            // Another producer claimed cell; retry.
+            else
+            {
+                pos = _pushPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ParallelJob* ParallelJobQueue::Pop()
+    {
+        uint64 pos = _popPos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto&  cell = _cells[pos & (CAPACITY - 1)];
+            uint64 seq  = cell.Sequence.load(std::memory_order_acquire);
+            auto   diff = (int64)seq - (int64)(pos + 1);
+
+            // Cell filled; claim it.
+            if (diff == 0)
+            {
+                if (_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    auto* job = cell.Job;
+                    cell.Sequence.store(pos + CAPACITY, std::memory_order_release);
+                    return job;
+                }
+            }
+            // Empty.
+            else if (diff < 0)
+            {
+                return nullptr;
+            }
+            // Another consumer claimed cell; retry.
+            else
+            {
+                pos = _popPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ParallelTaskManager::~ParallelTaskManager()
+    {
+        Deinitialize();
+    }
+
     uint ParallelTaskManager::GetThreadCount() const
     {
-        return (uint)_threads.size();
+        return (uint)_workers.size();
+    }
+
+    ParallelLaneStats ParallelTaskManager::GetLaneStats(ParallelPriority priority) const
+    {
+        return ParallelLaneStats
+        {
+            .CompletedGroupCount = _completedGroupCounts[(int)priority].load(std::memory_order_relaxed),
+            .MissedGroupCount    = _missedGroupCounts[(int)priority].load(std::memory_order_relaxed)
+        };
+    }
+
+    const ParallelThreadStats& ParallelTaskManager::GetWorkerStats(uint workerIdx) const
+    {
+        return _workers[workerIdx]->Stats;
+    }
+
+    const ParallelThreadStats& ParallelTaskManager::GetHelperStats() const
+    {
+        return _helperStats;
+    }
+
+    std::span<const float> ParallelTaskManager::GetQueueDepthSamples() const
+    {
+        return _queueDepthSamples;
+    }
+
+    uint ParallelTaskManager::GetQueueDepthSampleOffset() const
+    {
+        return _queueDepthSampleIdx;
+    }
+
+    json ParallelTaskManager::GetStatsJson() const
+    {
+        auto workersJson = json::array();
+        for (const auto& worker : _workers)
+        {
+            workersJson.push_back(ToStatsJson(worker->Stats));
+        }
+
+        auto lanesJson = json::array();
+        for (int i = 0; i < (int)ParallelPriority::Count; i++)
+        {
+            auto stats = GetLaneStats((ParallelPriority)i);
+            lanesJson.push_back(json
+            {
+                { "CompletedGroupCount", stats.CompletedGroupCount },
+                { "MissedGroupCount",    stats.MissedGroupCount }
+            });
+        }
+
+        // Order queue depth samples oldest first.
+        auto queueDepthJson = json::array();
+        for (int i = 0; (uint)i < PARALLEL_QUEUE_DEPTH_SAMPLE_COUNT; i++)
+        {
+            queueDepthJson.push_back(_queueDepthSamples[(_queueDepthSampleIdx + i) % PARALLEL_QUEUE_DEPTH_SAMPLE_COUNT]);
+        }
+
+        return json
+        {
+            { "Workers",    workersJson },
+            { "Helpers",    ToStatsJson(_helperStats) },
+            { "Lanes",      lanesJson },
+            { "QueueDepth", queueDepthJson }
+        };
     }
 
     void ParallelTaskManager::Initialize()
     {
-        // Reserve threads.
-        uint threadCount = GetCoreCount() * 2;
-        _threads.reserve(threadCount);
+        const auto& options = g_App.GetOptions();
+
+        Initialize((uint)std::clamp(options->ParallelWorkerCount, 0, PARALLEL_WORKER_MAX), options->ParallelReservedCoreMask, options->EnableParallelAffinity);
+    }
 
-        // Create threads.
+    void ParallelTaskManager::Initialize(uint threadCount, uint64 reservedCoreMask, bool enableAffinity)
+    {
+        // Default to one worker per available core, leaving one core for main thread.
+        auto coreIds = GetAvailableCoreIds(reservedCoreMask);
+        if (threadCount == 0)
+        {
+            threadCount = std::max((uint)coreIds.size() - 1, 1u);
+        }
+        else if (threadCount > coreIds.size())
+        {
+            Log("Parallel worker count " + std::to_string(threadCount) + " oversubscribes " + std::to_string(coreIds.size()) + " available cores.",
+                LogLevel::Warning, LogMode::Debug);
+        }
+
+        _deinitialize = false;
+        for (auto& sharedJobs : _sharedJobs)
+        {
+            sharedJobs = std::make_unique<ParallelJobQueue>();
+        }
+
+        // Create pools once. Kept across reinitialization, since outstanding handles may still reference groups.
+        if (_jobPool == nullptr)
+        {
+            _jobPool   = std::make_unique<ParallelJob[]>(JOB_POOL_SIZE);
+            _groupPool = std::make_unique<ParallelGroup[]>(GROUP_POOL_SIZE);
+            _freeJobIds.Initialize(JOB_POOL_SIZE);
+            _freeGroupIds.Initialize(GROUP_POOL_SIZE);
+
+            for (int i = 0; (uint)i < GROUP_POOL_SIZE; i++)
+            {
+                _groupPool[i].Manager = this;
+            }
+        }
+
+        // Create workers before starting threads, since any worker may steal from any other.
+        _workers.reserve(threadCount);
+        for (int i = 0; (uint)i < threadCount; i++)
+        {
+            auto worker      = std::make_unique<ParallelWorker>();
+            worker->RngState = (uint64)(i + 1) * 0x9E3779B97F4A7C15;
+            _workers.push_back(std::move(worker));
+        }
+
+        // Start threads.
         for (int i = 0; (uint)i < threadCount; i++)
         {
-            _threads.push_back(std::jthread(&ParallelTaskManager::Worker, this));
+            _workers[i]->Thread = std::jthread(&ParallelTaskManager::Worker, this, (uint)i);
+        }
+
+        // Pin workers round-robin to available cores.
+        if (enableAffinity)
+        {
+            for (int i = 0; (uint)i < threadCount; i++)
+            {
+                SetThreadAffinity(_workers[i]->Thread, coreIds[i % coreIds.size()]);
+            }
         }
     }
 
     void ParallelTaskManager::Deinitialize()
     {
-        // LOCK: Restrict shutdown flag access.
+        if (_workers.empty())
         {
-            auto taskLock = std::lock_guard(_taskMutex);
-
-            _deinitialize = true;
+            return;
         }
 
         // Notify all threads they should stop.
-        _taskCond.notify_all();
+        _deinitialize = true;
+        _wakeSemaphore.release(_workers.size());
+
+        // Join all threads before releasing deques, since idle workers may still attempt steals.
+        for (auto& worker : _workers)
+        {
+            worker->Thread.join();
+        }
+        _workers.clear();
+
+        // Discard stale wakeup tokens.
+        while (_wakeSemaphore.try_acquire());
+        _sleepingWorkerCount = 0;
+    }
+
+    void ParallelTaskManager::BeginFrame(uint64 frameIntervalMicrosec)
+    {
+        _frameIntervalMicrosec.store(frameIntervalMicrosec, std::memory_order_relaxed);
+        _frameDeadlineMicrosec.store(GetSteadyMicrosec() + frameIntervalMicrosec, std::memory_order_relaxed);
+
+        // Sample queue depth.
+        if constexpr (IS_PARALLEL_STATS_BUILD)
+        {
+            _queueDepthSamples[_queueDepthSampleIdx] = (float)std::max(_pendingJobCount.load(std::memory_order_relaxed), 0);
+            _queueDepthSampleIdx                     = (_queueDepthSampleIdx + 1) % PARALLEL_QUEUE_DEPTH_SAMPLE_COUNT;
+        }
     }
 
     std::future<void> ParallelTaskManager::AddTask(const ParallelTask& task)
@@ -45,10 +494,17 @@ namespace Silent::Utils
 
     std::future<void> ParallelTaskManager::AddTasks(const ParallelTasks& tasks)
     {
+        struct LegacyGroup
+        {
+            ParallelTasks      Tasks   = {};
+            std::atomic<int>   Counter = 0;
+            std::promise<void> Promise = {};
+        };
+
         const auto& options = g_App.GetOptions();
 
-        // If parallelism is disabled, execute tasks sequentially.
-        if (!options->EnableParallelism)
+        // If parallelism is disabled or no workers exist, execute tasks sequentially.
+        if (!options->EnableParallelism || _workers.empty() || tasks.empty())
         {
             for (const auto& task : tasks)
             {
@@ -61,91 +517,502 @@ namespace Silent::Utils
             return GenerateReadyFuture();
         }
 
-        // HEAP ALLOC: Create counter and promise.
-        auto counter = std::make_shared<std::atomic<int>>();
-        auto promise = std::make_shared<std::promise<void>>();
+        // HEAP ALLOC: Create tasks, counter, and promise for legacy future. Freed by last job.
+        // Tasks are owned by group so jobs capture only pointer and index, which fits inline storage regardless of `std::function` size.
+        auto* legacyGroup = new LegacyGroup();
+        auto  future      = legacyGroup->Promise.get_future();
+        legacyGroup->Tasks = tasks;
+        legacyGroup->Counter.store((int)tasks.size(), std::memory_order_release);
+
+        // Add untracked jobs signaling legacy group.
+        for (int i = 0; (uint)i < tasks.size(); i++)
+        {
+            AddJob((ParallelGroup*)nullptr, [legacyGroup, i]()
+            {
+                const auto& task = legacyGroup->Tasks[i];
+                if (task)
+                {
+                    task();
+                }
+
+                if (legacyGroup->Counter.fetch_sub(1, std::memory_order::acq_rel) == 1)
+                {
+                    legacyGroup->Promise.set_value();
+                    delete legacyGroup;
+                }
+            });
+        }
+
+        // Return future to wait on task group completion if needed.
+        return future;
+    }
+
+    void ParallelTaskManager::AddMainThreadTask(const ParallelTask& task)
+    {
+        // LOCK: Restrict main thread task access.
+        auto lock = std::lock_guard(_mainThreadMutex);
 
-        counter->store((int)tasks.size(), std::memory_order::release);
+        _mainThreadTasks.push_back(task);
+    }
+
+    void ParallelTaskManager::ExecuteMainThreadTasks()
+    {
+        // Take queued tasks. Tasks queued while executing run next tick.
+        auto tasks = std::vector<ParallelTask>{};
+        {
+            // LOCK: Restrict main thread task access.
+            auto lock = std::lock_guard(_mainThreadMutex);
+
+            tasks.swap(_mainThreadTasks);
+        }
 
-        // Add group tasks.
         for (const auto& task : tasks)
         {
-            AddTask(task, counter, promise);
+            task();
         }
+    }
 
-        // Notify available threads to handle tasks.
-        _taskCond.notify_all();
+    ParallelHandle ParallelTaskManager::CreateGroup(ParallelPriority priority)
+    {
+        const auto& options = g_App.GetOptions();
 
-        // Return future to wait on task group completion if needed.
-        return promise->get_future();
+        // Parallelism disabled; jobs added to invalid group execute in place.
+        if (!options->EnableParallelism || _workers.empty())
+        {
+            return ParallelHandle();
+        }
+
+        // Pool exhausted; same fallback.
+        int groupId = _freeGroupIds.Pop();
+        if (groupId == NO_VALUE)
+        {
+            return ParallelHandle();
+        }
+
+        // Define lane deadline.
+        uint64 nowMicrosec      = GetSteadyMicrosec();
+        uint64 intervalMicrosec = _frameIntervalMicrosec.load(std::memory_order_relaxed);
+        uint64 deadlineMicrosec = 0;
+        switch (priority)
+        {
+            case ParallelPriority::Critical:
+            {
+                uint64 frameDeadlineMicrosec = _frameDeadlineMicrosec.load(std::memory_order_relaxed);
+                deadlineMicrosec             = (frameDeadlineMicrosec != 0) ? frameDeadlineMicrosec : (nowMicrosec + intervalMicrosec);
+                break;
+            }
+
+            default:
+            case ParallelPriority::Normal:
+            {
+                deadlineMicrosec = nowMicrosec + intervalMicrosec;
+                break;
+            }
+
+            case ParallelPriority::Background:
+            {
+                deadlineMicrosec = nowMicrosec + (intervalMicrosec * BACKGROUND_DEADLINE_FRAME_COUNT);
+                break;
+            }
+        }
+
+        // Hold open reference until group is closed.
+        auto& group            = _groupPool[groupId];
+        group.DeadlineMicrosec = deadlineMicrosec;
+        group.Priority.store(priority, std::memory_order_relaxed);
+        group.Counter.store(1, std::memory_order_relaxed);
+        return ParallelHandle(&group, group.Generation.load(std::memory_order_acquire));
     }
 
-    void ParallelTaskManager::Worker()
+    void ParallelTaskManager::CloseGroup(const ParallelHandle& group)
     {
+        if (group.GetGroup() == nullptr)
+        {
+            return;
+        }
+
+        // Release open reference.
+        ReleaseGroup(*group.GetGroup());
+    }
+
+    void ParallelTaskManager::Wait(const ParallelHandle& group)
+    {
+        // Help only with lanes at least as urgent as group's, so critical waits never pick up streaming work.
+        int  workerIdx      = (CurrentManager == this) ? CurrentWorkerIdx : NO_VALUE;
+        auto lowestPriority = group.GetGroup()->Priority.load(std::memory_order_relaxed);
+        uint spinCount      = 0;
+        while (!group.IsComplete())
+        {
+            // Help by executing any available job. Covers nested jobs waiting in own deque.
+            auto* job = GetJob(workerIdx, lowestPriority);
+            if (job != nullptr)
+            {
+                ExecuteJob(job);
+                spinCount = 0;
+                continue;
+            }
+
+            // Spin briefly, since remaining jobs are likely finishing on other workers.
+            // Workers never block, as jobs they push while waiting must stay reachable.
+            if (workerIdx != NO_VALUE || spinCount < SPIN_COUNT_MAX)
+            {
+                spinCount++;
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Queues drained; block until workers complete remaining jobs.
+            group.GetGroup()->Generation.wait(group.GetGeneration(), std::memory_order_acquire);
+        }
+    }
+
+    bool ParallelTaskManager::ExecutePendingJob(ParallelPriority lowestPriority)
+    {
+        if (_workers.empty())
+        {
+            return false;
+        }
+
+        int   workerIdx = (CurrentManager == this) ? CurrentWorkerIdx : NO_VALUE;
+        auto* job       = GetJob(workerIdx, lowestPriority);
+        if (job == nullptr)
+        {
+            return false;
+        }
+
+        ExecuteJob(job);
+        return true;
+    }
+
+    ParallelJob* ParallelTaskManager::AllocateJob(ParallelGroup* group)
+    {
+        if (_jobPool == nullptr || _workers.empty())
+        {
+            return nullptr;
+        }
+
+        int jobId = _freeJobIds.Pop();
+        if (jobId == NO_VALUE)
+        {
+            return nullptr;
+        }
+
+        // Register job with group.
+        if (group != nullptr)
+        {
+            group->Counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto& job = _jobPool[jobId];
+        job.Group = group;
+        return &job;
+    }
+
+    bool ParallelTaskManager::RetainGroup(const ParallelHandle& group)
+    {
+        auto* groupPtr = group.GetGroup();
+        if (groupPtr == nullptr)
+        {
+            return false;
+        }
+
+        // Acquire reference unless group already completed.
+        int count = groupPtr->Counter.load(std::memory_order_acquire);
+        do
+        {
+            if (count <= 0)
+            {
+                return false;
+            }
+        }
+        while (!groupPtr->Counter.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        // Group was recycled since handle was created; return reference to new owner.
+        if (group.IsComplete())
+        {
+            ReleaseGroup(*groupPtr);
+            return false;
+        }
+
+        return true;
+    }
+
+    void ParallelTaskManager::ReleaseGroup(ParallelGroup& group)
+    {
+        if (group.Counter.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        // Detach continuations before recycling.
+        auto* continuation = group.Continuations.exchange(nullptr, std::memory_order_acquire);
+
+        // Track lane deadline.
+        int priorityIdx = (int)group.Priority.load(std::memory_order_relaxed);
+        _completedGroupCounts[priorityIdx].fetch_add(1, std::memory_order_relaxed);
+        if (GetSteadyMicrosec() > group.DeadlineMicrosec)
+        {
+            _missedGroupCounts[priorityIdx].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Complete group and recycle it.
+        group.Generation.fetch_add(1, std::memory_order_release);
+        group.Generation.notify_all();
+        _freeGroupIds.Push((uint)(&group - _groupPool.get()));
+
+        // Submit continuations.
+        while (continuation != nullptr)
+        {
+            auto* next = continuation->Next;
+            continuation->Next = nullptr;
+            SubmitJobs(std::span(&continuation, 1));
+            continuation = next;
+        }
+    }
+
+    void ParallelTaskManager::AttachContinuation(const ParallelHandle& group, ParallelJob* job)
+    {
+        // Predecessor already complete; submit immediately.
+        if (!RetainGroup(group))
+        {
+            SubmitJobs(std::span(&job, 1));
+            return;
+        }
+
+        // Push onto predecessor's continuation list. Held reference prevents completion meanwhile.
+        auto& groupRef = *group.GetGroup();
+        auto* head     = groupRef.Continuations.load(std::memory_order_relaxed);
+        do
+        {
+            job->Next = head;
+        }
+        while (!groupRef.Continuations.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+
+        ReleaseGroup(groupRef);
+    }
+
+    void ParallelTaskManager::Worker(uint workerIdx)
+    {
+        CurrentManager   = this;
+        CurrentWorkerIdx = (int)workerIdx;
+
+        uint spinCount = 0;
         while (true)
         {
-            auto task = ParallelTask();
+            // Execute available job. Background lane yields near frame deadline.
+            auto  lowestPriority = IsBackgroundYielding() ? ParallelPriority::Normal : ParallelPriority::Background;
+            auto* job            = GetJob(workerIdx, lowestPriority);
+            if (job != nullptr)
+            {
+                ExecuteJob(job);
+                spinCount = 0;
+                continue;
+            }
 
-            // LOCK: Restrict task queue access.
+            // Shutting down and no pending jobs; return early.
+            if (_deinitialize && _pendingJobCount.load() <= 0)
             {
-                auto taskLock = std::unique_lock(_taskMutex);
-                _taskCond.wait(taskLock, [this]
-                {
-                    return (_deinitialize || !_tasks.empty());
-                });
+                break;
+            }
 
-                // Shutting down and no pending tasks; return early.
-                if (_deinitialize && _tasks.empty())
-                {
-                    return;
-                }
+            // Spin briefly before sleeping, since fine-grained jobs often arrive in bursts.
+            uint64 idleStartNanosec = GetStatsNanosec();
+            if (spinCount < SPIN_COUNT_MAX)
+            {
+                spinCount++;
+                std::this_thread::yield();
+                AddStat(_workers[workerIdx]->Stats.IdleNanosec, GetStatsNanosec() - idleStartNanosec);
+                continue;
+            }
+
+            SleepWorker();
+            AddStat(_workers[workerIdx]->Stats.IdleNanosec, GetStatsNanosec() - idleStartNanosec);
+            spinCount = 0;
+        }
 
-                // Get task.
-                task = _tasks.front();
-                _tasks.pop();
+        CurrentManager   = nullptr;
+        CurrentWorkerIdx = NO_VALUE;
+    }
+
+    void ParallelTaskManager::SubmitJobs(std::span<ParallelJob*> jobs)
+    {
+        if (jobs.empty())
+        {
+            return;
+        }
+
+        // Push to own lane deque if called from worker, otherwise to shared lane queue.
+        auto*  worker         = (CurrentManager == this) ? _workers[CurrentWorkerIdx].get() : nullptr;
+        uint   queuedCount    = 0;
+        uint64 enqueueNanosec = GetStatsNanosec();
+        for (auto* job : jobs)
+        {
+            if constexpr (IS_PARALLEL_STATS_BUILD)
+            {
+                job->EnqueueNanosec = enqueueNanosec;
             }
 
-            // Execute task.
-            if (task)
+            int laneIdx = (int)((job->Group != nullptr) ? job->Group->Priority.load(std::memory_order_relaxed) : ParallelPriority::Normal);
+            if ((worker != nullptr && worker->Jobs[laneIdx].Push(job)) || _sharedJobs[laneIdx]->Push(job))
             {
-                task();
+                queuedCount++;
+                continue;
             }
 
-            // Periodically check for interruption.
-            std::this_thread::yield();
+            // Queues full; execute job in place as backpressure.
+            ExecuteJob(job);
         }
+
+        // Wake only as many sleeping workers as there are new jobs.
+        _pendingJobCount.fetch_add((int)queuedCount);
+        WakeWorkers(queuedCount);
     }
 
-    void ParallelTaskManager::AddTask(const ParallelTask& task, std::shared_ptr<std::atomic<int>> counter, std::shared_ptr<std::promise<void>> promise)
+    ParallelJob* ParallelTaskManager::GetJob(int workerIdx, ParallelPriority lowestPriority)
     {
-        // Increment counter for task group.
-        counter->fetch_add(1, std::memory_order_relaxed);
+        auto* worker      = (workerIdx != NO_VALUE) ? _workers[workerIdx].get() : nullptr;
+        uint  workerCount = (uint)_workers.size();
+
+        // Xorshift step.
+        uint64& rngState = (worker != nullptr) ? worker->RngState : HelperRngState;
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 7;
+        rngState ^= rngState << 17;
+        uint startIdx = (uint)(rngState % workerCount);
 
-        // LOCK: Restrict task queue access.
+        // Drain lanes in priority order.
+        ParallelJob* job = nullptr;
+        for (int laneIdx = 0; laneIdx <= (int)lowestPriority && job == nullptr; laneIdx++)
         {
-            auto taskLock = std::unique_lock(_taskMutex);
+            // Pop from own deque.
+            if (worker != nullptr)
+            {
+                job = worker->Jobs[laneIdx].Pop();
+            }
 
-            // Add task with promise and counter handling.
-            _tasks.push([this, task, counter, promise]()
+            // Pop from shared queue.
+            if (job == nullptr)
             {
-                HandleTask(task, *counter, *promise);
-            });
+                job = _sharedJobs[laneIdx]->Pop();
+            }
+
+            // Steal from random victim.
+            if (job == nullptr)
+            {
+                uint64 stealStartNanosec = GetStatsNanosec();
+                for (int i = 0; (uint)i < workerCount && job == nullptr; i++)
+                {
+                    uint victimIdx = (startIdx + i) % workerCount;
+                    if (victimIdx != (uint)workerIdx)
+                    {
+                        job = _workers[victimIdx]->Jobs[laneIdx].Steal();
+                    }
+                }
+
+                auto& stats = GetThreadStats(workerIdx);
+                AddStat(stats.StealNanosec, GetStatsNanosec() - stealStartNanosec);
+                AddStat(stats.StealCount, (job != nullptr) ? 1 : 0);
+            }
+        }
+
+        if (job != nullptr)
+        {
+            _pendingJobCount.fetch_sub(1);
         }
+        return job;
     }
 
-    void ParallelTaskManager::HandleTask(const ParallelTask& task, std::atomic<int>& counter, std::promise<void>& promise)
+    void ParallelTaskManager::ExecuteJob(ParallelJob* job)
     {
+        auto* group = job->Group;
+
         // Execute task.
-        if (task)
+        if constexpr (IS_PARALLEL_STATS_BUILD)
         {
-            task();
+            uint64 enqueueNanosec = job->EnqueueNanosec;
+            uint64 startNanosec   = GetStatsNanosec();
+
+            ExecuteDepth++;
+            job->Execute(job->Storage.data());
+            ExecuteDepth--;
+
+            // Collect stats. Busy time of nested jobs is already covered by outermost job.
+            uint64 endNanosec = GetStatsNanosec();
+            auto&  stats      = GetThreadStats((CurrentManager == this) ? CurrentWorkerIdx : NO_VALUE);
+            AddStat(stats.ExecutedJobCount, 1);
+            AddStat(stats.BusyNanosec, (ExecuteDepth == 0) ? (endNanosec - startNanosec) : 0);
+            AddHistogramSample(stats.LatencyHistogram, startNanosec - enqueueNanosec);
+            AddHistogramSample(stats.ExecutionHistogram, endNanosec - startNanosec);
+        }
+        else
+        {
+            job->Execute(job->Storage.data());
+        }
+
+        // Recycle job.
+        job->Execute = nullptr;
+        job->Group   = nullptr;
+        _freeJobIds.Push((uint)(job - _jobPool.get()));
+
+        // Check for group completion.
+        if (group != nullptr)
+        {
+            ReleaseGroup(*group);
+        }
+    }
+
+    ParallelThreadStats& ParallelTaskManager::GetThreadStats(int workerIdx)
+    {
+        return (workerIdx != NO_VALUE) ? _workers[workerIdx]->Stats : _helperStats;
+    }
+
+    bool ParallelTaskManager::IsBackgroundYielding() const
+    {
+        uint64 frameDeadlineMicrosec = _frameDeadlineMicrosec.load(std::memory_order_relaxed);
+        if (frameDeadlineMicrosec == 0)
+        {
+            return false;
+        }
+
+        // Yield only inside window before deadline. Overrun frames must not starve background lane until next frame begins.
+        uint64 nowMicrosec = GetSteadyMicrosec();
+        return nowMicrosec < frameDeadlineMicrosec && (nowMicrosec + BACKGROUND_YIELD_MICROSEC) >= frameDeadlineMicrosec;
+    }
+
+    void ParallelTaskManager::WakeWorkers(uint count)
+    {
+        int sleepingCount = _sleepingWorkerCount.load();
+        while (sleepingCount > 0)
+        {
+            int wakeCount = std::min(sleepingCount, (int)count);
+            if (_sleepingWorkerCount.compare_exchange_weak(sleepingCount, sleepingCount - wakeCount))
+            {
+                _wakeSemaphore.release(wakeCount);
+                return;
+            }
         }
+    }
+
+    void ParallelTaskManager::SleepWorker()
+    {
+        _sleepingWorkerCount.fetch_add(1);
 
-        // Check for task group completion.
-        if (counter.fetch_sub(1, std::memory_order::acq_rel) == 1)
+        // Recheck after registering to avoid missing a wakeup from concurrent submission.
+        if (_pendingJobCount.load() > 0 || _deinitialize)
         {
-            promise.set_value();
+            // Unregister if no submitter claimed this worker yet.
+            int sleepingCount = _sleepingWorkerCount.load();
+            while (sleepingCount > 0)
+            {
+                if (_sleepingWorkerCount.compare_exchange_weak(sleepingCount, sleepingCount - 1))
+                {
+                    return;
+                }
+            }
         }
+
+        // Sleep until woken. Wakeup tokens persist, so release before acquire is not lost.
+        _wakeSemaphore.acquire();
     }
 
     uint GetCoreCount()
@@ -153,10 +1020,210 @@ namespace Silent::Utils
         return std::max(std::jthread::hardware_concurrency(), 1u);
     }
 
+    std::vector<uint> GetAvailableCoreIds(uint64 reservedCoreMask)
+    {
+        constexpr uint MASK_CORE_COUNT = std::numeric_limits<uint64>::digits;
+
+        // Collect cores not reserved by mask. Cores beyond mask width are always available.
+        uint coreCount = GetCoreCount();
+        auto coreIds   = std::vector<uint>{};
+        coreIds.reserve(coreCount);
+        for (int i = 0; (uint)i < coreCount; i++)
+        {
+            if ((uint)i >= MASK_CORE_COUNT || !(reservedCoreMask & ((uint64)1 << i)))
+            {
+                coreIds.push_back((uint)i);
+            }
+        }
+
+        // All cores reserved; ignore mask.
+        if (coreIds.empty())
+        {
+            Log("Parallel reserved core mask excludes all cores. Ignoring mask.", LogLevel::Warning);
+
+            for (int i = 0; (uint)i < coreCount; i++)
+            {
+                coreIds.push_back((uint)i);
+            }
+        }
+
+        return coreIds;
+    }
+
     std::future<void> GenerateReadyFuture()
     {
         auto promise = std::promise<void>();
         promise.set_value();
         return promise.get_future();
     }
+
+    // Runs batches on minimal shared mutex and condition variable queue, as scheduler before work stealing. Returns tasks per second.
+    static float BenchmarkBaselineQueue(uint threadCount, uint taskCount, uint batchSize, const std::function<void(uint)>& task)
+    {
+        auto tasks        = std::queue<ParallelTask>{};
+        auto taskMutex    = std::mutex();
+        auto taskCond     = std::condition_variable();
+        bool deinitialize = false;
+
+        // HEAP ALLOC: Create threads draining shared queue.
+        auto threads = std::vector<std::jthread>{};
+        threads.reserve(threadCount);
+        for (int i = 0; (uint)i < threadCount; i++)
+        {
+            threads.push_back(std::jthread([&]()
+            {
+                while (true)
+                {
+                    auto curTask = ParallelTask();
+
+                    // LOCK: Restrict task queue access.
+                    {
+                        auto taskLock = std::unique_lock(taskMutex);
+                        taskCond.wait(taskLock, [&]()
+                        {
+                            return deinitialize || !tasks.empty();
+                        });
+
+                        // Shutting down and no pending tasks; return early.
+                        if (deinitialize && tasks.empty())
+                        {
+                            return;
+                        }
+
+                        curTask = std::move(tasks.front());
+                        tasks.pop();
+                    }
+
+                    curTask();
+                }
+            }));
+        }
+
+        // Submit batches and wait on each. Tasks are pushed one lock at a time and batches complete through shared counter and promise.
+        auto startTime      = std::chrono::high_resolution_clock::now();
+        uint submittedCount = 0;
+        while (submittedCount < taskCount)
+        {
+            // HEAP ALLOC: Create counter and promise.
+            auto counter = std::make_shared<std::atomic<int>>((int)batchSize);
+            auto promise = std::make_shared<std::promise<void>>();
+            auto future  = promise->get_future();
+
+            for (int i = 0; (uint)i < batchSize; i++)
+            {
+                // LOCK: Restrict task queue access.
+                auto taskLock = std::lock_guard(taskMutex);
+
+                tasks.push([&task, idx = submittedCount + (uint)i, counter, promise]()
+                {
+                    task(idx);
+                    if (counter->fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        promise->set_value();
+                    }
+                });
+            }
+            taskCond.notify_all();
+
+            future.wait();
+            submittedCount += batchSize;
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        // LOCK: Restrict shutdown flag access.
+        {
+            auto taskLock = std::lock_guard(taskMutex);
+            deinitialize  = true;
+        }
+        taskCond.notify_all();
+        threads.clear();
+
+        float sec = std::chrono::duration<float>(endTime - startTime).count();
+        return (sec > 0.0f) ? ((float)submittedCount / sec) : 0.0f;
+    }
+
+    std::vector<ParallelBenchmarkResult> BenchmarkParallelism(const std::vector<uint>& threadCounts, uint taskCount, uint batchSize, bool compareBaseline)
+    {
+        constexpr uint TASK_ITERATION_COUNT = 256;
+
+        auto results = std::vector<ParallelBenchmarkResult>{};
+        results.reserve(threadCounts.size());
+
+        // Create small, independent task.
+        auto sink = std::atomic<uint>(0);
+        auto task = [&sink](uint idx)
+        {
+            uint hash = 2166136261 ^ idx;
+            for (int i = 0; (uint)i < TASK_ITERATION_COUNT; i++)
+            {
+                hash = (hash ^ (uint)i) * 16777619;
+            }
+
+            sink.fetch_add(hash, std::memory_order_relaxed);
+        };
+
+        const auto& options = g_App.GetOptions();
+
+        batchSize = std::max(batchSize, 1u);
+        for (uint threadCount : threadCounts)
+        {
+            // HEAP ALLOC: Create isolated manager with configured topology to avoid disturbing `g_Parallel`.
+            auto manager = std::make_unique<ParallelTaskManager>();
+            manager->Initialize(threadCount, options->ParallelReservedCoreMask, options->EnableParallelAffinity);
+
+            // Submit batches and wait on each, simulating per-tick job bursts.
+            auto startTime      = std::chrono::high_resolution_clock::now();
+            uint submittedCount = 0;
+            while (submittedCount < taskCount)
+            {
+                manager->AddJobs(batchSize, task).Wait();
+                submittedCount += batchSize;
+            }
+            auto endTime = std::chrono::high_resolution_clock::now();
+
+            manager->Deinitialize();
+
+            // Collect result.
+            float sec    = std::chrono::duration<float>(endTime - startTime).count();
+            auto  result = ParallelBenchmarkResult
+            {
+                .ThreadCount = threadCount,
+                .TaskCount   = submittedCount,
+                .TasksPerSec = (sec > 0.0f) ? ((float)submittedCount / sec) : 0.0f
+            };
+
+            // Compare against baseline queue with same workload.
+            if (compareBaseline)
+            {
+                result.BaselineTasksPerSec = BenchmarkBaselineQueue(threadCount, taskCount, batchSize, task);
+            }
+            results.push_back(result);
+
+            Log("Parallel benchmark: " + std::to_string(threadCount) + " threads, " + std::to_string(submittedCount) + " tasks, " +
+                std::to_string((uint)result.TasksPerSec) + " tasks/s" +
+                (compareBaseline ? (", baseline " + std::to_string((uint)result.BaselineTasksPerSec) + " tasks/s.") : "."));
+        }
+
+        return results;
+    }
+
+    uint BenchmarkParallelWorkerCounts(uint taskCount, uint batchSize)
+    {
+        // Sweep every worker count up to twice core count to expose oversubscription cost.
+        auto threadCounts = std::vector<uint>{};
+        for (int i = 1; (uint)i <= std::min(GetCoreCount() * 2, (uint)PARALLEL_WORKER_MAX); i++)
+        {
+            threadCounts.push_back((uint)i);
+        }
+        auto results = BenchmarkParallelism(threadCounts, taskCount, batchSize, false);
+
+        // Find fastest worker count.
+        const auto& bestResult = *std::max_element(results.begin(), results.end(), [](const auto& result0, const auto& result1)
+        {
+            return result0.TasksPerSec < result1.TasksPerSec;
+        });
+
+        Log("Parallel benchmark: Fastest worker count is " + std::to_string(bestResult.ThreadCount) + ".");
+        return bestResult.ThreadCount;
+    }
 }
@@ -1,47 +1,581 @@
 #pragma once
 
+// References:
+// https://www.di.ens.fr/~zappa/readings/ppopp13.pdf
+// https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+
 namespace Silent::Utils
 {
+#ifdef PARALLEL_STATS
+    constexpr bool IS_PARALLEL_STATS_BUILD = true;
+#else
+    constexpr bool IS_PARALLEL_STATS_BUILD = IS_DEBUG_BUILD;
+#endif
+
+    constexpr uint PARALLEL_HISTOGRAM_BUCKET_COUNT   = 32;
+    constexpr uint PARALLEL_QUEUE_DEPTH_SAMPLE_COUNT = 256;
+
     using ParallelTask  = std::function<void()>;
     using ParallelTasks = std::vector<ParallelTask>;
 
+    class ParallelTaskManager;
+    struct ParallelJob;
+
+    /** @brief Scheduling lane. Workers drain lanes in order, and background lane yields near frame deadline. */
+    enum class ParallelPriority
+    {
+        Critical,   // Frame-critical work. Deadline is end of current frame.
+        Normal,     // General work. Deadline is one frame interval after creation.
+        Background, // Streaming work such as asset loading. Deadline is several frame intervals after creation.
+
+        Count
+    };
+
+    struct ParallelGroup
+    {
+        std::atomic<int>              Counter          = 0;                        // Pending jobs plus one open reference held until `CloseGroup`.
+        std::atomic<uint>             Generation       = 0;                        // Incremented on completion. Invalidates handles when group is recycled.
+        std::atomic<ParallelJob*>     Continuations    = nullptr;                  // Intrusive list of jobs submitted on completion.
+        std::atomic<ParallelPriority> Priority         = ParallelPriority::Normal; // Lane of jobs in group.
+        uint64                        DeadlineMicrosec = 0;                        // Completion deadline for lane stats.
+        ParallelTaskManager*          Manager          = nullptr;                  // Owning manager whose queues waiters help drain.
+    };
+
+    /** @brief Lightweight completion handle for a pooled job group. Default-constructed handle is always complete. */
+    class ParallelHandle
+    {
+    private:
+        // Fields
+
+        ParallelGroup* _group      = nullptr;
+        uint           _generation = 0;
+
+    public:
+        // Constructors
+
+        ParallelHandle() = default;
+        ParallelHandle(ParallelGroup* group, uint generation) : _group(group), _generation(generation) {}
+
+        // Getters
+
+        ParallelGroup* GetGroup() const;
+        uint           GetGeneration() const;
+
+        // Inquirers
+
+        bool IsComplete() const;
+
+        // Utilities
+
+        /** @brief Executes queued jobs on the calling thread until group completes. Safe to call from within jobs. */
+        void Wait() const;
+    };
+
+    /** @brief Pooled job with inline callable storage. */
+    struct alignas(64) ParallelJob
+    {
+        static constexpr uint STORAGE_SIZE = 40;
+
+        alignas(std::max_align_t) std::array<std::byte, STORAGE_SIZE> Storage = {};
+
+        void (*Execute)(void* storage) = nullptr; // Invokes and destroys stored callable.
+        ParallelGroup* Group           = nullptr;
+        union
+        {
+            ParallelJob* Next = nullptr; // Next continuation of predecessor group while attached.
+            uint64       EnqueueNanosec; // Enqueue time once submitted. Stats builds only.
+        };
+    };
+
+    /** @brief Lock-free free list of pool indices. Head is tagged to avoid ABA. */
+    class ParallelFreeList
+    {
+    private:
+        // Fields
+
+        std::unique_ptr<std::atomic<uint>[]> _nextIds = nullptr; // Next ID + 1, 0 = end.
+        std::atomic<uint64>                  _head    = 0;       // Low 32 bits = ID + 1, high 32 bits = tag.
+
+    public:
+        // Constructors
+
+        ParallelFreeList() = default;
+
+        // Utilities
+
+        void Initialize(uint capacity);
+        int  Pop();
+        void Push(uint id);
+    };
+
+    /** @brief Fixed-capacity Chase-Lev work-stealing deque. Owner pushes and pops at the bottom, thieves steal from the top without locking. */
+    class ParallelJobDeque
+    {
+    public:
+        // Constants
+
+        static constexpr uint CAPACITY = 1 << 12;
+
+    private:
+        // Fields
+
+        alignas(64) std::atomic<int64> _top    = 0;
+        alignas(64) std::atomic<int64> _bottom = 0;
+        std::array<std::atomic<ParallelJob*>, CAPACITY> _jobs = {};
+
+    public:
+        // Constructors
+
+        ParallelJobDeque() = default;
+
+        // Getters
+
+        uint GetSize() const;
+
+        // Utilities
+
+        bool         Push(ParallelJob* job); // NOTE: Owner thread only.
+        ParallelJob* Pop();                  // NOTE: Owner thread only.
+        ParallelJob* Steal();
+    };
+
+    /** @brief Fixed-capacity lock-free multi-producer multi-consumer queue. Receives jobs submitted from non-worker threads. */
+    class ParallelJobQueue
+    {
+    public:
+        // Constants
+
+        static constexpr uint CAPACITY = 1 << 12;
+
+    private:
+        struct Cell
+        {
+            std::atomic<uint64> Sequence = 0;
+            ParallelJob*        Job      = nullptr;
+        };
+
+        // Fields
+
+        alignas(64) std::atomic<uint64> _pushPos = 0;
+        alignas(64) std::atomic<uint64> _popPos  = 0;
+        std::array<Cell, CAPACITY>      _cells   = {};
+
+    public:
+        // Constructors
+
+        ParallelJobQueue();
+
+        // Utilities
+
+        bool         Push(ParallelJob* job);
+        ParallelJob* Pop();
+    };
+
+    /** @brief Scheduler counters of one thread. Histogram buckets are log2 nanoseconds. Counters stay zero unless `IS_PARALLEL_STATS_BUILD`, which compiles in their updates. */
+    struct alignas(64) ParallelThreadStats
+    {
+        using Histogram = std::array<std::atomic<uint64>, PARALLEL_HISTOGRAM_BUCKET_COUNT>;
+
+        std::atomic<uint64> ExecutedJobCount   = 0;
+        std::atomic<uint64> StealCount         = 0;
+        std::atomic<uint64> BusyNanosec        = 0;
+        std::atomic<uint64> IdleNanosec        = 0;
+        std::atomic<uint64> StealNanosec       = 0;
+        Histogram           LatencyHistogram   = {}; // Enqueue-to-start time.
+        Histogram           ExecutionHistogram = {}; // Execution time.
+    };
+
+    struct ParallelWorker
+    {
+        std::array<ParallelJobDeque, (int)ParallelPriority::Count> Jobs     = {}; // Deque per lane.
+        std::jthread                                               Thread   = {};
+        uint64                                                     RngState = 0;  // Victim selection state.
+        ParallelThreadStats                                        Stats    = {};
+    };
+
+    struct ParallelLaneStats
+    {
+        uint64 CompletedGroupCount = 0;
+        uint64 MissedGroupCount    = 0; // Groups completed after their lane deadline.
+    };
+
     class ParallelTaskManager
     {
     private:
+        // Constants
+
+        static constexpr uint   SPIN_COUNT_MAX                  = 64;
+        static constexpr uint   JOB_POOL_SIZE                   = 1 << 13;
+        static constexpr uint   GROUP_POOL_SIZE                 = 1 << 10;
+        static constexpr uint   BACKGROUND_DEADLINE_FRAME_COUNT = 30;
+        static constexpr uint64 BACKGROUND_YIELD_MICROSEC       = 2000;
+        static constexpr uint64 DEFAULT_FRAME_INTERVAL_MICROSEC = 1000000 / 60;
+
         // Fields
 
-        std::vector<std::jthread> _threads      = {};
-        std::queue<ParallelTask>  _tasks        = {};
-        std::mutex                _taskMutex    = {};
-        std::condition_variable   _taskCond     = {};
-        bool                      _deinitialize = false;
+        std::unique_ptr<ParallelJob[]>   _jobPool      = nullptr;
+        std::unique_ptr<ParallelGroup[]> _groupPool    = nullptr;
+        ParallelFreeList                 _freeJobIds   = {};
+        ParallelFreeList                 _freeGroupIds = {};
+
+        std::vector<std::unique_ptr<ParallelWorker>>                                _workers             = {};
+        std::array<std::unique_ptr<ParallelJobQueue>, (int)ParallelPriority::Count> _sharedJobs          = {}; // Shared queue per lane.
+        std::atomic<int>                                                            _pendingJobCount     = 0;
+        std::atomic<int>                                                            _sleepingWorkerCount = 0;
+        std::counting_semaphore<>                                                   _wakeSemaphore       = std::counting_semaphore<>(0);
+        std::atomic<bool>                                                           _deinitialize        = false;
+
+        std::atomic<uint64>                                           _frameDeadlineMicrosec = 0;
+        std::atomic<uint64>                                           _frameIntervalMicrosec = DEFAULT_FRAME_INTERVAL_MICROSEC;
+        std::array<std::atomic<uint64>, (int)ParallelPriority::Count> _completedGroupCounts  = {};
+        std::array<std::atomic<uint64>, (int)ParallelPriority::Count> _missedGroupCounts     = {};
+
+        std::vector<ParallelTask> _mainThreadTasks = {};
+        std::mutex                _mainThreadMutex = {};
+
+        ParallelThreadStats                                  _helperStats         = {}; // Shared by non-worker threads helping while waiting.
+        std::array<float, PARALLEL_QUEUE_DEPTH_SAMPLE_COUNT> _queueDepthSamples   = {}; // Pending job count per frame. Ring buffer.
+        uint                                                 _queueDepthSampleIdx = 0;
 
     public:
         // Constructors, destructors
 
         ParallelTaskManager() = default;
+        ~ParallelTaskManager();
 
         // Getters
 
-        uint GetThreadCount() const;
+        uint                       GetThreadCount() const;
+        ParallelLaneStats          GetLaneStats(ParallelPriority priority) const;
+        const ParallelThreadStats& GetWorkerStats(uint workerIdx) const;
+        const ParallelThreadStats& GetHelperStats() const;
+        std::span<const float>     GetQueueDepthSamples() const;
+        uint                       GetQueueDepthSampleOffset() const;
+        json                       GetStatsJson() const;
 
         // Utilities
 
         void              Initialize();
+        void              Initialize(uint threadCount, uint64 reservedCoreMask = 0, bool enableAffinity = false);
         void              Deinitialize();
+        void              BeginFrame(uint64 frameIntervalMicrosec);
         std::future<void> AddTask(const ParallelTask& task);
         std::future<void> AddTasks(const ParallelTasks& tasks);
 
+        /** @brief Queues task to run on main thread when it next calls `ExecuteMainThreadTasks`, i.e. at start of next tick. */
+        void AddMainThreadTask(const ParallelTask& task);
+        void ExecuteMainThreadTasks();
+
+        // Allocation-free utilities
+
+        ParallelHandle CreateGroup(ParallelPriority priority = ParallelPriority::Normal);
+        void           CloseGroup(const ParallelHandle& group);
+        void           Wait(const ParallelHandle& group);
+
+        /** @brief Executes one pending job from lanes at least as urgent as `lowestPriority` on calling thread. Returns `false` if none was available. */
+        bool ExecutePendingJob(ParallelPriority lowestPriority = ParallelPriority::Normal);
+
+        /** @brief Adds a job to an open group. Executes in place if the group is invalid or the job pool is exhausted. */
+        template <typename TFunc>
+        void AddJob(const ParallelHandle& group, TFunc&& func)
+        {
+            if (group.GetGroup() == nullptr)
+            {
+                func();
+                return;
+            }
+
+            AddJob(group.GetGroup(), std::forward<TFunc>(func));
+        }
+
+        /** @brief Adds `count` jobs invoking `func(idx)` as a single closed group. */
+        template <typename TFunc>
+        ParallelHandle AddJobs(uint count, const TFunc& func, ParallelPriority priority = ParallelPriority::Normal)
+        {
+            auto group = CreateGroup(priority);
+            for (int i = 0; (uint)i < count; i++)
+            {
+                AddJob(group, [func, i]()
+                {
+                    func((uint)i);
+                });
+            }
+
+            CloseGroup(group);
+            return group;
+        }
+
+        /** @brief Schedules `func` to run once `group` completes, without blocking. Returns handle of continuation.
+         * Executes in place after waiting if pools are exhausted. */
+        template <typename TFunc>
+        ParallelHandle AddContinuation(const ParallelHandle& group, TFunc&& func, ParallelPriority priority = ParallelPriority::Normal)
+        {
+            // Invalid continuation group; wait and execute in place.
+            auto continuation = CreateGroup(priority);
+            if (continuation.GetGroup() == nullptr)
+            {
+                group.Wait();
+                func();
+                return continuation;
+            }
+
+            // Job pool exhausted; same fallback.
+            auto* job = CreateJob(continuation.GetGroup(), std::forward<TFunc>(func));
+            if (job == nullptr)
+            {
+                group.Wait();
+                func();
+                CloseGroup(continuation);
+                return continuation;
+            }
+
+            // Attach to predecessor. Continuation group stays open through job's reference.
+            CloseGroup(continuation);
+            AttachContinuation(group, job);
+            return continuation;
+        }
+
     private:
         // Helpers
 
-        void Worker();
-        void AddTask(const ParallelTask& task, std::shared_ptr<std::atomic<int>> counter, std::shared_ptr<std::promise<void>> promise);
-        void HandleTask(const ParallelTask& task, std::atomic<int>& counter, std::promise<void>& promise);
+        /** @brief Allocates job storing `func` inline. Returns `nullptr` without consuming `func` if pool is exhausted. */
+        template <typename TFunc>
+        ParallelJob* CreateJob(ParallelGroup* group, TFunc&& func)
+        {
+            using TCallable = std::decay_t<TFunc>;
+            static_assert(sizeof(TCallable) <= ParallelJob::STORAGE_SIZE, "Job callable exceeds inline storage. Capture large state by reference.");
+            static_assert(alignof(TCallable) <= alignof(std::max_align_t), "Job callable alignment exceeds inline storage alignment.");
+
+            auto* job = AllocateJob(group);
+            if (job == nullptr)
+            {
+                return nullptr;
+            }
+
+            // Store callable inline.
+            new (job->Storage.data()) TCallable(std::forward<TFunc>(func));
+            job->Execute = [](void* storage)
+            {
+                auto& callable = *std::launder((TCallable*)storage);
+                callable();
+                callable.~TCallable();
+            };
+
+            return job;
+        }
+
+        template <typename TFunc>
+        void AddJob(ParallelGroup* group, TFunc&& func)
+        {
+            // Pool exhausted; execute in place as backpressure.
+            auto* job = CreateJob(group, std::forward<TFunc>(func));
+            if (job == nullptr)
+            {
+                func();
+                return;
+            }
+
+            SubmitJobs(std::span(&job, 1));
+        }
+
+        ParallelJob* AllocateJob(ParallelGroup* group);
+        bool         RetainGroup(const ParallelHandle& group);
+        void         ReleaseGroup(ParallelGroup& group);
+        void         AttachContinuation(const ParallelHandle& group, ParallelJob* job);
+
+        void         Worker(uint workerIdx);
+        void         SubmitJobs(std::span<ParallelJob*> jobs);
+        ParallelJob* GetJob(int workerIdx, ParallelPriority lowestPriority);
+        void         ExecuteJob(ParallelJob* job);
+        bool         IsBackgroundYielding() const;
+        void         WakeWorkers(uint count);
+        void         SleepWorker();
+
+        ParallelThreadStats& GetThreadStats(int workerIdx);
+    };
+
+    struct ParallelBenchmarkResult
+    {
+        uint  ThreadCount         = 0;
+        uint  TaskCount           = 0;
+        float TasksPerSec         = 0.0f;
+        float BaselineTasksPerSec = 0.0f; // Shared mutex and condition variable queue replaced by work-stealing scheduler. 0 if not compared.
     };
 
     extern ParallelTaskManager g_Parallel;
 
     uint              GetCoreCount();
+    std::vector<uint> GetAvailableCoreIds(uint64 reservedCoreMask);
     std::future<void> GenerateReadyFuture();
+
+    /** @brief Benchmarks task throughput of isolated schedulers per thread count. Optionally compares against baseline shared queue. */
+    std::vector<ParallelBenchmarkResult> BenchmarkParallelism(const std::vector<uint>& threadCounts, uint taskCount, uint batchSize, bool compareBaseline = true);
+
+    /** @brief Benchmarks every worker count from 1 to twice the core count. Returns fastest worker count. */
+    uint BenchmarkParallelWorkerCounts(uint taskCount, uint batchSize);
+
+    // Data-parallel range utilities. Calling thread takes part in the work.
+
+    constexpr uint PARALLEL_CHUNK_COUNT_MAX = 256;
+
+    /** @brief Executes `body(idx)` or `body(chunkStart, chunkEnd)` over `[start, end)` in parallel.
+     * Chunks are claimed dynamically with guided sizing: large while much work remains, shrinking toward `grainSize` to balance the tail.
+     * Safe to nest, since waiting threads execute pending helper jobs themselves. */
+    template <typename TFunc>
+    void ParallelFor(int start, int end, int grainSize, const TFunc& body)
+    {
+        if (start >= end)
+        {
+            return;
+        }
+
+        // Execute chunk.
+        auto executeChunk = [&](int chunkStart, int chunkEnd)
+        {
+            if constexpr (std::is_invocable_v<const TFunc&, int, int>)
+            {
+                body(chunkStart, chunkEnd);
+            }
+            else
+            {
+                for (int i = chunkStart; i < chunkEnd; i++)
+                {
+                    body(i);
+                }
+            }
+        };
+
+        // Too little work or no workers; execute in place.
+        grainSize        = std::max(grainSize, 1);
+        int  chunkCount  = ((end - start) + (grainSize - 1)) / grainSize;
+        uint helperCount = std::min(g_Parallel.GetThreadCount(), (uint)(chunkCount - 1));
+        if (helperCount == 0)
+        {
+            executeChunk(start, end);
+            return;
+        }
+
+        // Claim chunks until range is exhausted.
+        auto cursor        = std::atomic<int>(start);
+        int  divisor       = (int)(helperCount + 1) * 2;
+        auto executeChunks = [&]()
+        {
+            int chunkStart = cursor.load(std::memory_order_relaxed);
+            while (chunkStart < end)
+            {
+                int chunkSize = std::max(grainSize, (end - chunkStart) / divisor);
+                int chunkEnd  = std::min(chunkStart + chunkSize, end);
+                if (cursor.compare_exchange_weak(chunkStart, chunkEnd, std::memory_order_relaxed))
+                {
+                    executeChunk(chunkStart, chunkEnd);
+                    chunkStart = cursor.load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        // Spawn helpers and participate.
+        auto group = g_Parallel.AddJobs(helperCount, [&executeChunks](uint)
+        {
+            executeChunks();
+        });
+        executeChunks();
+        group.Wait();
+    }
+
+    /** @brief Maps `[start, end)` with `mapFunc(idx)` and folds results with associative `reduceFunc(a, b)`.
+     * Chunking depends only on range and `grainSize`, so results are deterministic regardless of thread count. */
+    template <typename T, typename TMapFunc, typename TReduceFunc>
+    T ParallelReduce(int start, int end, int grainSize, const T& identity, const TMapFunc& mapFunc, const TReduceFunc& reduceFunc)
+    {
+        if (start >= end)
+        {
+            return identity;
+        }
+
+        // Define fixed chunks.
+        int count      = end - start;
+        int chunkSize  = std::max({ grainSize, 1, (count + ((int)PARALLEL_CHUNK_COUNT_MAX - 1)) / (int)PARALLEL_CHUNK_COUNT_MAX });
+        int chunkCount = (count + (chunkSize - 1)) / chunkSize;
+
+        // HEAP ALLOC: Reduce chunks into partials.
+        auto partials = std::vector<T>(chunkCount, identity);
+        ParallelFor(0, chunkCount, 1, [&](int chunkIdx)
+        {
+            int chunkStart = start + (chunkIdx * chunkSize);
+            int chunkEnd   = std::min(chunkStart + chunkSize, end);
+
+            auto partial = identity;
+            for (int i = chunkStart; i < chunkEnd; i++)
+            {
+                partial = reduceFunc(partial, mapFunc(i));
+            }
+
+            partials[chunkIdx] = std::move(partial);
+        });
+
+        // Fold partials in order.
+        auto result = identity;
+        for (const auto& partial : partials)
+        {
+            result = reduceFunc(result, partial);
+        }
+
+        return result;
+    }
+
+    /** @brief Computes inclusive prefix scan of `input` into `output` with associative `reduceFunc(a, b)`.
+     * Two parallel passes: chunk totals, then chunk scans seeded with scanned totals. `output` may alias `input`. */
+    template <typename T, typename TReduceFunc>
+    void ParallelScan(std::type_identity_t<std::span<const T>> input, std::type_identity_t<std::span<T>> output, const T& identity, const TReduceFunc& reduceFunc, int grainSize)
+    {
+        Assert(output.size() >= input.size(), "ParallelScan: Output smaller than input.");
+        if (input.empty())
+        {
+            return;
+        }
+
+        // Define fixed chunks.
+        int count      = (int)input.size();
+        int chunkSize  = std::max({ grainSize, 1, (count + ((int)PARALLEL_CHUNK_COUNT_MAX - 1)) / (int)PARALLEL_CHUNK_COUNT_MAX });
+        int chunkCount = (count + (chunkSize - 1)) / chunkSize;
+
+        // HEAP ALLOC: Compute chunk totals.
+        auto offsets = std::vector<T>(chunkCount, identity);
+        ParallelFor(0, chunkCount, 1, [&](int chunkIdx)
+        {
+            int chunkStart = chunkIdx * chunkSize;
+            int chunkEnd   = std::min(chunkStart + chunkSize, count);
+
+            auto total = identity;
+            for (int i = chunkStart; i < chunkEnd; i++)
+            {
+                total = reduceFunc(total, input[i]);
+            }
+
+            offsets[chunkIdx] = std::move(total);
+        });
+
+        // Convert totals to exclusive chunk offsets.
+        auto carry = identity;
+        for (auto& offset : offsets)
+        {
+            auto total = std::move(offset);
+            offset     = carry;
+            carry      = reduceFunc(carry, total);
+        }
+
+        // Scan chunks seeded with offsets.
+        ParallelFor(0, chunkCount, 1, [&](int chunkIdx)
+        {
+            int chunkStart = chunkIdx * chunkSize;
+            int chunkEnd   = std::min(chunkStart + chunkSize, count);
+
+            auto acc = offsets[chunkIdx];
+            for (int i = chunkStart; i < chunkEnd; i++)
+            {
+                acc       = reduceFunc(acc, input[i]);
+                output[i] = acc;
+            }
+        });
+    }
 }
@@ -0,0 +1,200 @@
+#include "Framework.h"
+#include "Utils/ParallelGraph.h"
+
+#include "Utils/Parallel.h"
+
+namespace Silent::Utils
+{
+    uint ParallelGraph::GetNodeCount() const
+    {
+        return (uint)_nodes.size();
+    }
+
+    int ParallelGraph::AddNode(const ParallelTask& task, bool isMainThread)
+    {
+        _nodes.push_back(Node
+        {
+            .Task         = task,
+            .IsMainThread = isMainThread
+        });
+        if (isMainThread)
+        {
+            _mainThreadNodeCount++;
+        }
+
+        return (int)_nodes.size() - 1;
+    }
+
+    void ParallelGraph::AddDependency(int predecessorNodeId, int successorNodeId)
+    {
+        if (predecessorNodeId < 0 || predecessorNodeId >= _nodes.size() ||
+            successorNodeId < 0 || successorNodeId >= _nodes.size() ||
+            predecessorNodeId == successorNodeId)
+        {
+            Log("Attempted to add invalid parallel graph dependency " + std::to_string(predecessorNodeId) + " -> " + std::to_string(successorNodeId) + ".",
+                LogLevel::Warning, LogMode::Debug);
+            return;
+        }
+
+        _nodes[predecessorNodeId].SuccessorIds.push_back(successorNodeId);
+        _nodes[successorNodeId].PredecessorCount++;
+    }
+
+    void ParallelGraph::Clear()
+    {
+        _nodes.clear();
+        _mainThreadNodeCount = 0;
+    }
+
+    ParallelHandle ParallelGraph::Run(ParallelPriority priority)
+    {
+        if constexpr (IS_DEBUG_BUILD)
+        {
+            Assert(_mainThreadNodeCount == 0, "Parallel graph: Main thread nodes require `Execute`.");
+        }
+
+        auto group = Submit(priority);
+        g_Parallel.CloseGroup(group);
+        return group;
+    }
+
+    void ParallelGraph::Execute(ParallelPriority priority)
+    {
+        auto group = Submit(priority);
+
+        // Run main thread nodes as they become ready, lowest ID first. Help with ready jobs while none are.
+        uint remainingCount = _mainThreadNodeCount;
+        while (remainingCount != 0)
+        {
+            uint readyCount = _mainThreadReadyCount.load(std::memory_order_acquire);
+
+            int readyNodeId = NO_VALUE;
+            for (int i = 0; i < _nodes.size(); i++)
+            {
+                if (_nodes[i].IsMainThread && _pendingCounts[i].load(std::memory_order_acquire) == 0)
+                {
+                    readyNodeId = i;
+                    break;
+                }
+            }
+
+            if (readyNodeId == NO_VALUE)
+            {
+                if (!g_Parallel.ExecutePendingJob(priority))
+                {
+                    _mainThreadReadyCount.wait(readyCount, std::memory_order_acquire);
+                }
+
+                continue;
+            }
+
+            _pendingCounts[readyNodeId].store(NO_VALUE, std::memory_order_relaxed);
+            ExecuteNode(group, readyNodeId);
+            remainingCount--;
+        }
+
+        g_Parallel.CloseGroup(group);
+        group.Wait();
+    }
+
+    ParallelHandle ParallelGraph::Submit(ParallelPriority priority)
+    {
+        if constexpr (IS_DEBUG_BUILD)
+        {
+            Assert(Validate(), "Parallel graph: Dependency cycle detected.");
+        }
+
+        // HEAP ALLOC: Grow pending counters when node count exceeds previous run.
+        if (_pendingSize < _nodes.size())
+        {
+            _pendingCounts = std::make_unique<std::atomic<int>[]>(_nodes.size());
+            _pendingSize   = (uint)_nodes.size();
+        }
+
+        // Reset pending counters.
+        for (int i = 0; i < _nodes.size(); i++)
+        {
+            _pendingCounts[i].store(_nodes[i].PredecessorCount, std::memory_order_relaxed);
+        }
+
+        // Submit root worker nodes. Successors are submitted into same group as they become ready. Group stays open until run closes it.
+        auto group = g_Parallel.CreateGroup(priority);
+        for (int i = 0; i < _nodes.size(); i++)
+        {
+            if (!_nodes[i].IsMainThread && _nodes[i].PredecessorCount == 0)
+            {
+                g_Parallel.AddJob(group, [this, group, i]()
+                {
+                    ExecuteNode(group, i);
+                });
+            }
+        }
+
+        return group;
+    }
+
+    bool ParallelGraph::Validate() const
+    {
+        // Kahn's algorithm. Graph is acyclic if every node is visited.
+        auto predecessorCounts = std::vector<int>(_nodes.size());
+        auto readyNodeIds      = std::vector<int>{};
+        for (int i = 0; i < _nodes.size(); i++)
+        {
+            predecessorCounts[i] = _nodes[i].PredecessorCount;
+            if (predecessorCounts[i] == 0)
+            {
+                readyNodeIds.push_back(i);
+            }
+        }
+
+        uint visitedCount = 0;
+        while (!readyNodeIds.empty())
+        {
+            int nodeId = readyNodeIds.back();
+            readyNodeIds.pop_back();
+            visitedCount++;
+
+            for (int successorNodeId : _nodes[nodeId].SuccessorIds)
+            {
+                if (--predecessorCounts[successorNodeId] == 0)
+                {
+                    readyNodeIds.push_back(successorNodeId);
+                }
+            }
+        }
+
+        return visitedCount == _nodes.size();
+    }
+
+    void ParallelGraph::ExecuteNode(const ParallelHandle& group, int nodeId)
+    {
+        const auto& node = _nodes[nodeId];
+        if (node.Task)
+        {
+            node.Task();
+        }
+
+        // Release successors whose last predecessor this was. Ready worker nodes are submitted, ready main thread nodes are signaled.
+        // Running job keeps group open.
+        for (int successorNodeId : node.SuccessorIds)
+        {
+            if (_pendingCounts[successorNodeId].fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                continue;
+            }
+
+            if (_nodes[successorNodeId].IsMainThread)
+            {
+                _mainThreadReadyCount.fetch_add(1, std::memory_order_release);
+                _mainThreadReadyCount.notify_one();
+            }
+            else
+            {
+                g_Parallel.AddJob(group, [this, group, successorNodeId]()
+                {
+                    ExecuteNode(group, successorNodeId);
+                });
+            }
+        }
+    }
+}
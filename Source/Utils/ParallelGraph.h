@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Utils/Parallel.h"
+
+namespace Silent::Utils
+{
+    /** @brief Reusable directed acyclic graph of tasks. Nodes are submitted once all predecessors complete.
+     * Graph must outlive run and must not be modified or rerun until run completes.
+     * Main thread nodes run on thread calling `Execute` rather than as jobs, for work bound to main thread such as SDL and rendering. */
+    class ParallelGraph
+    {
+    private:
+        struct Node
+        {
+            ParallelTask     Task             = {};
+            std::vector<int> SuccessorIds     = {};
+            int              PredecessorCount = 0;
+            bool             IsMainThread     = false;
+        };
+
+        // Fields
+
+        std::vector<Node>                   _nodes                = {};
+        std::unique_ptr<std::atomic<int>[]> _pendingCounts        = nullptr; // Remaining predecessors per node during run. `NO_VALUE` once main thread node ran.
+        uint                                _pendingSize          = 0;
+        uint                                _mainThreadNodeCount  = 0;
+        std::atomic<uint>                   _mainThreadReadyCount = 0; // Incremented whenever main thread node becomes ready during run.
+
+    public:
+        // Constructors
+
+        ParallelGraph() = default;
+
+        // Getters
+
+        uint GetNodeCount() const;
+
+        // Utilities
+
+        int  AddNode(const ParallelTask& task, bool isMainThread = false);
+        void AddDependency(int predecessorNodeId, int successorNodeId);
+        void Clear();
+
+        /** @brief Submits graph and returns handle to wait on. Graph must have no main thread nodes. */
+        ParallelHandle Run(ParallelPriority priority = ParallelPriority::Normal);
+
+        /** @brief Runs graph and returns once complete. Must be called from main thread.
+         * Ready main thread nodes run on calling thread, lowest ID first, helping with pending jobs while none are ready. */
+        void Execute(ParallelPriority priority = ParallelPriority::Normal);
+
+    private:
+        // Helpers
+
+        ParallelHandle Submit(ParallelPriority priority);
+        void           ExecuteNode(const ParallelHandle& group, int nodeId);
+
+        // Debug helpers
+
+        bool Validate() const;
+    };
+}
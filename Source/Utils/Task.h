@@ -0,0 +1,334 @@
+#pragma once
+
+#include "Utils/Parallel.h"
+
+namespace Silent::Utils
+{
+    template <typename T>
+    class Task;
+
+    /** @brief Shared coroutine state of `Task`. Frame is destroyed once both coroutine and task release it. */
+    class TaskPromiseBase
+    {
+    private:
+        // Fields
+
+        std::atomic<void*> _state    = nullptr; // `nullptr` = running, `this` = complete, otherwise address of awaiting coroutine.
+        std::atomic<int>   _refCount = 2;       // Held by coroutine until final suspend and by owning task.
+
+    protected:
+        std::exception_ptr _exception = nullptr;
+
+    public:
+        // Awaiters
+
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_resume() const noexcept {}
+
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) const noexcept
+            {
+                auto& promise = handle.promise();
+
+                // Mark complete and take awaiting coroutine.
+                void* continuation = promise._state.exchange(&promise, std::memory_order_acq_rel);
+                promise._state.notify_all();
+
+                auto next = (continuation != nullptr) ? std::coroutine_handle<>::from_address(continuation) : std::noop_coroutine();
+                promise.Release(handle);
+
+                // Resume awaiting coroutine on this thread.
+                return next;
+            }
+        };
+
+        // Getters
+
+        void Rethrow() const
+        {
+            if (_exception != nullptr)
+            {
+                std::rethrow_exception(_exception);
+            }
+        }
+
+        // Inquirers
+
+        bool IsComplete() const
+        {
+            return _state.load(std::memory_order_acquire) == this;
+        }
+
+        // Utilities
+
+        /** @brief Registers coroutine to resume on completion. Returns `false` if already complete. Supports one awaiter. */
+        bool AddContinuation(std::coroutine_handle<> continuation)
+        {
+            void* state = nullptr;
+            if (_state.compare_exchange_strong(state, continuation.address(), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return true;
+            }
+
+            Assert(state == this, "Task: Awaited by more than one coroutine.");
+            return false;
+        }
+
+        void Wait() const
+        {
+            void* state = _state.load(std::memory_order_acquire);
+            while (state != this)
+            {
+                _state.wait(state, std::memory_order_acquire);
+                state = _state.load(std::memory_order_acquire);
+            }
+        }
+
+        template <typename TPromise>
+        void Release(std::coroutine_handle<TPromise> handle)
+        {
+            if (_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                handle.destroy();
+            }
+        }
+
+        // Coroutine hooks
+
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        FinalAwaiter       final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception()
+        {
+            _exception = std::current_exception();
+        }
+    };
+
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase
+    {
+    private:
+        // Fields
+
+        std::optional<T> _result = std::nullopt;
+
+    public:
+        // Getters
+
+        T& GetResult()
+        {
+            Rethrow();
+            return *_result;
+        }
+
+        // Coroutine hooks
+
+        Task<T> get_return_object();
+
+        template <typename TValue>
+        void return_value(TValue&& value)
+        {
+            _result.emplace(std::forward<TValue>(value));
+        }
+    };
+
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase
+    {
+    public:
+        // Getters
+
+        void GetResult()
+        {
+            Rethrow();
+        }
+
+        // Coroutine hooks
+
+        Task<void> get_return_object();
+
+        void return_void() {}
+    };
+
+    /** @brief Eagerly started coroutine. Runs on calling thread until first suspension, e.g. `co_await ResumeOnWorker()`.
+     * Task may be dropped before completion; coroutine then runs detached. */
+    template <typename T = void>
+    class Task
+    {
+    public:
+        // Aliases
+
+        using promise_type = TaskPromise<T>;
+
+    private:
+        // Fields
+
+        std::coroutine_handle<promise_type> _handle = nullptr;
+
+    public:
+        // Constructors, destructors
+
+        Task() = default;
+        explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+        Task(const Task& task) = delete;
+        Task(Task&& task) noexcept : _handle(std::exchange(task._handle, nullptr)) {}
+
+        ~Task()
+        {
+            if (_handle != nullptr)
+            {
+                _handle.promise().Release(_handle);
+            }
+        }
+
+        // Inquirers
+
+        bool IsComplete() const
+        {
+            return _handle == nullptr || _handle.promise().IsComplete();
+        }
+
+        // Utilities
+
+        /** @brief Blocks until complete and returns result. Rethrows exception raised by coroutine.
+         * NOTE: Prefer `co_await`. Must not be called from main thread on task awaiting `ResumeOnMainThread`. */
+        decltype(auto) Get()
+        {
+            Assert(_handle != nullptr, "Task: Attempted to get result of empty task.");
+
+            _handle.promise().Wait();
+            return _handle.promise().GetResult();
+        }
+
+        // Operators
+
+        Task& operator=(const Task& task) = delete;
+
+        Task& operator=(Task&& task) noexcept
+        {
+            if (this != &task)
+            {
+                this->~Task();
+                _handle = std::exchange(task._handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        /** @brief Suspends awaiting coroutine until task completes. Awaiting coroutine resumes on thread that completes task. */
+        auto operator co_await() const noexcept
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> Handle = nullptr;
+
+                bool await_ready() const noexcept
+                {
+                    return Handle.promise().IsComplete();
+                }
+
+                bool await_suspend(std::coroutine_handle<> continuation) const noexcept
+                {
+                    return Handle.promise().AddContinuation(continuation);
+                }
+
+                decltype(auto) await_resume() const
+                {
+                    return Handle.promise().GetResult();
+                }
+            };
+
+            Assert(_handle != nullptr, "Task: Attempted to await empty task.");
+            return Awaiter{ _handle };
+        }
+    };
+
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object()
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object()
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    /** @brief Awaiter resuming coroutine as job on worker pool. Continues in place if parallelism is unavailable. */
+    struct WorkerAwaiter
+    {
+        ParallelPriority Priority = ParallelPriority::Normal;
+
+        bool await_ready() const noexcept { return false; }
+        void await_resume() const noexcept {}
+
+        bool await_suspend(std::coroutine_handle<> handle) const
+        {
+            auto group = g_Parallel.CreateGroup(Priority);
+            if (group.GetGroup() == nullptr)
+            {
+                return false;
+            }
+
+            g_Parallel.AddJob(group, [handle]()
+            {
+                handle.resume();
+            });
+            g_Parallel.CloseGroup(group);
+            return true;
+        }
+    };
+
+    /** @brief Awaiter resuming coroutine on main thread at start of next tick. */
+    struct MainThreadAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_resume() const noexcept {}
+
+        void await_suspend(std::coroutine_handle<> handle) const
+        {
+            g_Parallel.AddMainThreadTask([handle]()
+            {
+                handle.resume();
+            });
+        }
+    };
+
+    /** @brief Awaiter resuming coroutine as continuation job once job group completes. Continues in place if already complete. */
+    struct ParallelHandleAwaiter
+    {
+        ParallelHandle   Handle   = {};
+        ParallelPriority Priority = ParallelPriority::Normal;
+
+        bool await_ready() const noexcept { return Handle.IsComplete(); }
+        void await_resume() const noexcept {}
+
+        void await_suspend(std::coroutine_handle<> handle) const
+        {
+            // Copy handle, since coroutine may resume and destroy awaiter before `AddContinuation` returns.
+            auto group    = Handle;
+            auto priority = Priority;
+            g_Parallel.AddContinuation(group, [handle]()
+            {
+                handle.resume();
+            }, priority);
+        }
+    };
+
+    inline WorkerAwaiter ResumeOnWorker(ParallelPriority priority = ParallelPriority::Normal)
+    {
+        return WorkerAwaiter{ priority };
+    }
+
+    inline MainThreadAwaiter ResumeOnMainThread()
+    {
+        return MainThreadAwaiter{};
+    }
+
+    inline ParallelHandleAwaiter ResumeOnCompletion(const ParallelHandle& group, ParallelPriority priority = ParallelPriority::Normal)
+    {
+        return ParallelHandleAwaiter{ group, priority };
+    }
+}